@@ -1,7 +1,6 @@
 #include "NodeBase.hpp"
 
 #include <vector>
-#include <numeric>
 
 #include "imnodes.h"
 #include "implot.h"
@@ -25,8 +24,9 @@ void NodeBase::plotAGraph()
     
     if(ImPlot::BeginPlot(("Plot##" + std::to_string(id)).c_str(), ImVec2(400, 200)))
     {
-        static std::vector<double> xes(1000), yes(1000);
-        std::iota(xes.begin(), xes.end(), 0);
+        // Taken from the pool for this plot only, so nodes hold no plot memory between frames
+        auto points = Signals::BufferPool::Default()->acquire(cPlotPoints * sizeof(double));
+        double* yes = points.data<double>();
         std::shared_ptr<std::shared_ptr<Signals::SignalBase>> tempPahseLeft = signal.getData().phase;
         std::shared_ptr<std::shared_ptr<Signals::SignalBase>> tempPahseRight;
         if(animate)
@@ -50,9 +50,11 @@ void NodeBase::plotAGraph()
                 );
             }
         }
-        for(int i = 0; i < xes.size(); ++i)
+        Signals::SignalBase::StatefulMarks marks;
+        Signals::SignalBase::MarkStateful(signal, marks);
+        for(int i = 0; i < cPlotPoints; ++i)
         {
-            yes[i] = signal.get(xes[i]);
+            yes[i] = signal.get(i);
         }
         if(animate)
         {
@@ -65,21 +67,50 @@ void NodeBase::plotAGraph()
         }
         ImPlot::PlotLine(
             "##d",
-            xes.data(), 
-            yes.data(), 
-            xes.size()
+            yes,
+            cPlotPoints
         );
         ImPlot::EndPlot();
     }
     ImGui::Checkbox(("Animate##" + std::to_string(id)).c_str(), &animate);
 }
 
+void NodeBase::drawProfile()
+{
+    if(!signal || !*signal)
+        return;
+    auto* counters = (*signal)->getProfile();
+    if(!counters)
+        return;
+    const double share = profileTotal ? 100.0 * double(counters->nanoseconds) / double(profileTotal) : 0.0;
+    ImGui::TextDisabled("%.1f ns/sample  %.1f%%", counters->nanosecondsPerSample(), share);
+    if(ImGui::IsItemHovered())
+    {
+        ImGui::SetTooltip("%llu calls, %llu samples\n%llu buffer allocations\n%llu samples through get()\n%llu shared reads",
+            (unsigned long long)counters->calls, (unsigned long long)counters->samples,
+            (unsigned long long)counters->allocations, (unsigned long long)counters->fallbackSamples,
+            (unsigned long long)counters->sharedReads);
+    }
+}
+
+GraphDesc::Node NodeBase::getDesc() const
+{
+    GraphDesc::Node desc;
+    desc.id = id;
+    desc.type = getType();
+    ImVec2 pos = ImNodes::GetNodeGridSpacePos(id);
+    desc.x = pos.x;
+    desc.y = pos.y;
+    return desc;
+}
+
 void NodeBase::Draw()
 {
     ImNodes::BeginNode(id);
     ImNodes::BeginNodeTitleBar();
     ImGui::Text("Node Base. Id = %d", id);
     ImNodes::EndNodeTitleBar();
+    drawProfile();
     ImGui::Dummy(ImVec2(80.0f, 45.0f));
     ImNodes::EndNode();
 }   
@@ -3,19 +3,13 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 
 #include "Signals/SignalBase.hpp"
+#include "Graph/Graph.hpp"
 
 namespace DSP
 {
-enum NodeType
-{
-    Signal,
-    Function,
-    Constant,
-    Output
-};
-
 class NodeBase
 {
 public:
@@ -36,13 +30,26 @@ public:
 
     void plotAGraph();
 
+    virtual GraphDesc::Node getDesc() const;
+    virtual void setDesc(const GraphDesc::Node& desc) {}
+    // Free-form node parameter stored in the graph text table, such as a file path
+    virtual std::string getText() const { return {}; }
+    virtual void setText(const std::string& text) {}
+
 
 
     virtual void Draw();
     uint32_t getId() const { return id; }
+    // Sum of the exclusive time of every node in the editor, the base of the profile overlay's share
+    static void SetProfileTotal(uint64_t nanoseconds) { profileTotal = nanoseconds; }
     virtual ~NodeBase() = default;
 protected:
+    // ns/sample and share of graph time, drawn only in DSP_PROFILE builds
+    void drawProfile();
+
+    static inline uint64_t profileTotal = 0;
     static constexpr const double animationSpeed = 0.01;
+    static constexpr int cPlotPoints = 1000;
     bool animate = true;
     double animationPhase = 0.0;
     uint32_t id = 0;
@@ -5,8 +5,13 @@
 #include <imnodes.h>
 
 #include <utility>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <bit>
 
 #include "WAVController/WAVController.hpp"
+#include "Render/Renderer.hpp"
 
 namespace DSP
 {
@@ -27,6 +32,7 @@ void SignalNode::Draw()
     ImNodes::BeginNodeTitleBar();
     ImGui::Text("Signal id %d", id);
     ImNodes::EndNodeTitleBar();
+    drawProfile();
 
     ImNodes::BeginOutputAttribute(id + OutSignalAttrib);
     plotAGraph();
@@ -46,17 +52,21 @@ void SignalNode::Draw()
 
     ImNodes::BeginInputAttribute(id + InAmplitudeAttrib);
     ImGui::Text("Amplitude");
+    drawRateToggle(Signals::SignalData::Amplitude);
     ImNodes::EndInputAttribute();
     ImNodes::BeginInputAttribute(id + InFrequencyAttrib);
     ImGui::Text("Frequency");
+    drawRateToggle(Signals::SignalData::Frequency);
     ImNodes::EndInputAttribute();
     ImNodes::BeginInputAttribute(id + InPhaseAttrib);
     ImGui::Text("Phase");
+    drawRateToggle(Signals::SignalData::Phase);
     ImNodes::EndInputAttribute();
     if(signalType == 2)
     {
         ImNodes::BeginInputAttribute(id + InDAttrib);
         ImGui::Text("Duty cycle");
+        drawRateToggle(Signals::SignalData::Duty);
         ImNodes::EndInputAttribute();
     }
 
@@ -64,37 +74,46 @@ void SignalNode::Draw()
     ImNodes::EndNode();
 }
 
+void SignalNode::drawRateToggle(Signals::SignalData::Input input)
+{
+    auto& data = (*signal)->getData();
+    bool control = data.isControlRate(input);
+    ImGui::SameLine();
+    ImGui::PushID(input);
+    if(ImGui::Checkbox("k", &control))
+        data.setControlRate(input, control);
+    ImGui::PopID();
+    if(ImGui::IsItemHovered())
+        ImGui::SetTooltip("Control rate: evaluated every %u samples and interpolated", Signals::Block::cControlInterval);
+}
+
 void SignalNode::updateSignalType()
 {
     if(isSignalTypeChanged)
     {
-        switch(signalType)
-        {
-            case 0:
-                *signal = std::make_shared<DSP::Signals::Sin>((*signal)->getData());
-                break;
-            case 1:
-                *signal = std::make_shared<DSP::Signals::Cos>((*signal)->getData());
-                break;
-            case 2:
-                *signal = std::make_shared<DSP::Signals::Pulse>((*signal)->getData());
-                break;
-            case 3:
-                *signal = std::make_shared<DSP::Signals::Sawtooth>((*signal)->getData());
-                break;
-            case 4:
-                *signal = std::make_shared<DSP::Signals::Triangle>((*signal)->getData());
-                break;
-            case 5:
-                *signal = std::make_shared<DSP::Signals::Noise>((*signal)->getData());
-                break;
-        }
+        *signal = Graph::makeSignal(static_cast<SignalKind>(signalType), (*signal)->getData());
         isSignalTypeChanged = false;
     }
 }
 
 
 
+GraphDesc::Node SignalNode::getDesc() const
+{
+    GraphDesc::Node desc = NodeBase::getDesc();
+    desc.kind = signalType;
+    desc.value = (*signal)->getData().controlRate;
+    return desc;
+}
+
+void SignalNode::setDesc(const GraphDesc::Node& desc)
+{
+    signalType = desc.kind;
+    isSignalTypeChanged = true;
+    updateSignalType();
+    (*signal)->getData().controlRate = desc.controlRate();
+}
+
 FunctionNode::FunctionNode() :
     NodeBase()
 {
@@ -109,6 +128,7 @@ void FunctionNode::Draw()
     ImNodes::BeginNodeTitleBar();
     ImGui::Text("Function id %d", id);
     ImNodes::EndNodeTitleBar();
+    drawProfile();
 
     ImNodes::BeginStaticAttribute(id + StaticTypeAttrib);
     ImGui::Text("Type");
@@ -143,31 +163,30 @@ void FunctionNode::updateFunctionType()
 {
     if(isFunctionTypeChanged)
     {
-        switch(functionType)
-        {
-            case 0:
-                *signal = std::make_shared<DSP::Signals::SumParam>(
-                    std::move(dynamic_cast<Signals::ComplexSignal&>(**signal).getLeft()), 
-                    std::move(dynamic_cast<Signals::ComplexSignal&>(**signal).getRight())
-                );
-                break;
-            case 1:
-                *signal = std::make_shared<DSP::Signals::MulParam>(
-                    std::move(dynamic_cast<Signals::ComplexSignal&>(**signal).getLeft()), 
-                    std::move(dynamic_cast<Signals::ComplexSignal&>(**signal).getRight())
-                );
-                break;
-            case 2:
-                *signal = std::make_shared<DSP::Signals::freqModulator>(
-                    std::move(dynamic_cast<Signals::ComplexSignal&>(**signal).getLeft()), 
-                    std::move(dynamic_cast<Signals::ComplexSignal&>(**signal).getRight())
-                );
-                break;
-        }
+        auto& function = dynamic_cast<Signals::ComplexSignal&>(**signal);
+        *signal = Graph::makeFunction(
+            static_cast<FunctionKind>(functionType),
+            std::move(function.getLeft()),
+            std::move(function.getRight())
+        );
         isFunctionTypeChanged = false;
     }
 }
 
+GraphDesc::Node FunctionNode::getDesc() const
+{
+    GraphDesc::Node desc = NodeBase::getDesc();
+    desc.kind = functionType;
+    return desc;
+}
+
+void FunctionNode::setDesc(const GraphDesc::Node& desc)
+{
+    functionType = desc.kind;
+    isFunctionTypeChanged = true;
+    updateFunctionType();
+}
+
 ConstantNode::ConstantNode(double value) :
     NodeBase()
 {
@@ -181,6 +200,7 @@ void ConstantNode::Draw()
     ImNodes::BeginNodeTitleBar();
     ImGui::Text("Constant id %d", id);
     ImNodes::EndNodeTitleBar();
+    drawProfile();
 
     ImNodes::BeginOutputAttribute(id + OutValueAttrib);
     ImGui::Text("Value");
@@ -195,6 +215,17 @@ void ConstantNode::Draw()
     ImNodes::EndNode();
 }
 
+GraphDesc::Node ConstantNode::getDesc() const
+{
+    GraphDesc::Node desc = NodeBase::getDesc();
+    desc.value = dynamic_cast<const DSP::Signals::Constant&>(**signal).value;
+    return desc;
+}
+
+void ConstantNode::setDesc(const GraphDesc::Node& desc)
+{
+    dynamic_cast<DSP::Signals::Constant&>(**signal).set(desc.value);
+}
 
 void OutputNode::Draw()
 {
@@ -209,35 +240,460 @@ void OutputNode::Draw()
     ImNodes::EndInputAttribute();
 
     ImNodes::BeginStaticAttribute(id + StaticOutAttrib);
-    if(signal && (*signal)->isValid())
+    if(signal && *signal && DSP::Signals::SignalBase::IsValidGraph(**signal))
     {
         plotAGraph();
     }
     if(ImGui::Button("Play"))
     {
-        if(GenerateSound())
-            WAVController::PlaylayWAV(soundPoints);
+        playRequested = signal && *signal && DSP::Signals::SignalBase::IsValidGraph(**signal);
+    }
+    drawSaveTask();
+    ImNodes::EndStaticAttribute();
+
+    ImNodes::EndNode();
+}
+
+void OutputNode::drawSaveTask()
+{
+    if(saveTask && !saveTask->isDone())
+    {
+        char overlay[32];
+        std::snprintf(overlay, sizeof(overlay), "Saving %.0f%%", 100.0 * saveTask->getProgress());
+        ImGui::ProgressBar(static_cast<float>(saveTask->getProgress()), ImVec2(200, 0), overlay);
+        ImGui::SameLine();
+        if(ImGui::Button(("Cancel##" + std::to_string(id)).c_str()))
+            saveTask->cancel();
+        return;
     }
+    ImGui::SetNextItemWidth(80);
+    if(ImGui::InputFloat(("s##" + std::to_string(id)).c_str(), &saveSeconds, 0.0f, 0.0f, "%.1f"))
+        saveSeconds = std::max(saveSeconds, 0.1f);
+    ImGui::SameLine();
     if(ImGui::Button("Save"))
+        saveRequested = signal && *signal && DSP::Signals::SignalBase::IsValidGraph(**signal);
+    if(!saveTask)
+        return;
+    ImGui::SameLine();
+    const auto& result = saveTask->getResult().get();
+    if(result.ok)
+        ImGui::TextDisabled("%s in %.0f ms%s", getSavePath().c_str(), result.renderSeconds * 1e3, result.cached ? ", cached" : "");
+    else
+        ImGui::TextDisabled("%s", result.error.c_str());
+}
+
+static constexpr size_t cMinSpectrumSize = 512;
+
+void SpectrumNode::Draw()
+{
+    ImNodes::BeginNode(id);
+
+    ImNodes::BeginNodeTitleBar();
+    ImGui::Text("Spectrum id %d", id);
+    ImNodes::EndNodeTitleBar();
+
+    ImNodes::BeginInputAttribute(id + InSignalAttrib);
+    ImGui::Text("Signal");
+    ImNodes::EndInputAttribute();
+
+    ImNodes::BeginStaticAttribute(id + StaticPlotAttrib);
+    static const char* sizes[] = {"512", "1024", "2048", "4096", "8192"};
+    static const char* windows[] = {"Rectangular", "Hann", "Blackman"};
+    ImGui::SetNextItemWidth(100);
+    ImGui::Combo(("Size##" + std::to_string(id)).c_str(), &sizeIndex, sizes, IM_ARRAYSIZE(sizes));
+    ImGui::SetNextItemWidth(100);
+    ImGui::Combo(("Window##" + std::to_string(id)).c_str(), &windowType, windows, IM_ARRAYSIZE(windows));
+    if(signal && *signal && DSP::Signals::SignalBase::IsValidGraph(**signal))
+    {
+        updateSpectrum();
+        if(ImPlot::BeginPlot(("Spectrum##" + std::to_string(id)).c_str(), ImVec2(400, 200)))
+        {
+            ImPlot::SetupAxes("Hz", "dB");
+            ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+            ImPlot::SetupAxisLimits(ImAxis_Y1, -120.0, 6.0);
+            // Bin 0 is left out, it has no place on a log axis
+            ImPlot::PlotLine("##spectrum", frequencies.data() + 1, magnitudes.data() + 1, static_cast<int>(magnitudes.size() - 1));
+            ImPlot::EndPlot();
+        }
+    }
+    ImNodes::EndStaticAttribute();
+
+    ImNodes::EndNode();
+}
+
+void SpectrumNode::updateSpectrum()
+{
+    const size_t size = cMinSpectrumSize << sizeIndex;
+    auto window = static_cast<SpectrumAnalyzer::Window>(windowType);
+    if(!analyzer || analyzer->getSize() != size || analyzer->getWindow() != window)
+    {
+        analyzer = std::make_unique<SpectrumAnalyzer>(size, window);
+        samples.resize(size);
+        magnitudes.resize(analyzer->getBins());
+        frequencies.resize(analyzer->getBins());
+        for(size_t k = 0; k < frequencies.size(); ++k)
+            frequencies[k] = static_cast<float>(k) * SAMPLE_RATE / size;
+    }
+
+    Renderer renderer(signal);
+    renderer.render(samples);
+    analyzer->analyze(samples.data(), magnitudes.data());
+}
+
+GraphDesc::Node SpectrumNode::getDesc() const
+{
+    GraphDesc::Node desc = NodeBase::getDesc();
+    desc.kind = windowType;
+    desc.value = static_cast<double>(cMinSpectrumSize << sizeIndex);
+    return desc;
+}
+
+void SpectrumNode::setDesc(const GraphDesc::Node& desc)
+{
+    windowType = desc.kind;
+    sizeIndex = 0;
+    while(sizeIndex < 4 && (cMinSpectrumSize << sizeIndex) < desc.value)
+        ++sizeIndex;
+}
+
+ConvolutionNode::ConvolutionNode() :
+    NodeBase()
+{
+    signal = std::make_shared<std::shared_ptr<DSP::Signals::SignalBase>>(std::make_shared<DSP::Signals::Convolution>());
+}
+
+void ConvolutionNode::Draw()
+{
+    ImNodes::BeginNode(id);
+
+    ImNodes::BeginNodeTitleBar();
+    ImGui::Text("Convolution id %d", id);
+    ImNodes::EndNodeTitleBar();
+    drawProfile();
+
+    ImNodes::BeginInputAttribute(id + InSignalAttrib);
+    ImGui::Text("Signal");
+    ImNodes::EndInputAttribute();
+
+    ImNodes::BeginStaticAttribute(id + StaticPathAttrib);
+    ImGui::SetNextItemWidth(200);
+    ImGui::InputText(("Impulse##" + std::to_string(id)).c_str(), pathBuffer, sizeof(pathBuffer));
+    if(ImGui::Button(("Load##" + std::to_string(id)).c_str()))
+    {
+        path = pathBuffer;
+        loadKernel();
+    }
+    auto& kernel = dynamic_cast<const Signals::Convolution&>(**signal).getKernel();
+    if(kernel)
+        ImGui::Text("%zu taps", kernel->getTaps().size());
+    else
+        ImGui::Text("No impulse response");
+    ImNodes::EndStaticAttribute();
+
+    ImNodes::BeginOutputAttribute(id + OutSignalAttrib);
+    ImGui::Text("Value");
+    ImNodes::EndOutputAttribute();
+
+    ImNodes::EndNode();
+}
+
+void ConvolutionNode::setText(const std::string& text)
+{
+    path = text;
+    std::strncpy(pathBuffer, path.c_str(), sizeof(pathBuffer) - 1);
+    loadKernel();
+}
+
+void ConvolutionNode::loadKernel()
+{
+    dynamic_cast<Signals::Convolution&>(**signal).setKernel(Signals::Convolution::LoadKernel(path));
+}
+
+FilterNode::FilterNode() :
+    NodeBase()
+{
+    signal = std::make_shared<std::shared_ptr<DSP::Signals::SignalBase>>(std::make_shared<DSP::Signals::Filter>());
+}
+
+void FilterNode::Draw()
+{
+    ImNodes::BeginNode(id);
+
+    ImNodes::BeginNodeTitleBar();
+    ImGui::Text("Filter id %d", id);
+    ImNodes::EndNodeTitleBar();
+    drawProfile();
+
+    auto& filter = dynamic_cast<DSP::Signals::Filter&>(**signal);
+    ImNodes::BeginStaticAttribute(id + StaticTypeAttrib);
+    static const char* types[] = {"Low pass", "High pass", "Band pass", "Notch", "Peak", "Low shelf", "High shelf"};
+    int type = static_cast<int>(filter.getType());
+    ImGui::SetNextItemWidth(100);
+    if(ImGui::Combo(("Type##" + std::to_string(id)).c_str(), &type, types, IM_ARRAYSIZE(types)))
+        filter.setType(static_cast<DSP::Signals::Filter::Type>(type));
+    int sections = static_cast<int>(filter.getSections());
+    ImGui::SetNextItemWidth(100);
+    if(ImGui::SliderInt(("Sections##" + std::to_string(id)).c_str(), &sections, 1, static_cast<int>(DSP::Signals::Filter::cMaxSections)))
+        filter.setSections(sections);
+    ImNodes::EndStaticAttribute();
+
+    ImNodes::BeginInputAttribute(id + InSignalAttrib);
+    ImGui::Text("Signal");
+    ImNodes::EndInputAttribute();
+    ImNodes::BeginInputAttribute(id + InCutoffAttrib);
+    ImGui::Text("Cutoff");
+    ImNodes::EndInputAttribute();
+    ImNodes::BeginInputAttribute(id + InQAttrib);
+    ImGui::Text("Q");
+    ImNodes::EndInputAttribute();
+    if(filter.getType() >= DSP::Signals::Filter::Type::Peak)
     {
-        if(GenerateSound())
-            WAVController::CreateWAVFile("test.wav", soundPoints);
+        ImNodes::BeginInputAttribute(id + InGainAttrib);
+        ImGui::Text("Gain, dB");
+        ImNodes::EndInputAttribute();
     }
+
+    ImNodes::BeginOutputAttribute(id + OutSignalAttrib);
+    ImGui::Text("Value");
+    ImNodes::EndOutputAttribute();
+
+    ImNodes::EndNode();
+}
+
+GraphDesc::Node FilterNode::getDesc() const
+{
+    GraphDesc::Node desc = NodeBase::getDesc();
+    auto& filter = dynamic_cast<const DSP::Signals::Filter&>(**signal);
+    desc.kind = static_cast<int32_t>(filter.getType());
+    desc.value = static_cast<double>(filter.getSections());
+    return desc;
+}
+
+void FilterNode::setDesc(const GraphDesc::Node& desc)
+{
+    auto& filter = dynamic_cast<DSP::Signals::Filter&>(**signal);
+    filter.setType(static_cast<DSP::Signals::Filter::Type>(desc.kind));
+    filter.setSections(desc.sections());
+}
+
+OversampleNode::OversampleNode() :
+    NodeBase()
+{
+    signal = std::make_shared<std::shared_ptr<DSP::Signals::SignalBase>>(std::make_shared<DSP::Signals::Oversample>());
+}
+
+void OversampleNode::Draw()
+{
+    ImNodes::BeginNode(id);
+
+    ImNodes::BeginNodeTitleBar();
+    ImGui::Text("Oversample id %d", id);
+    ImNodes::EndNodeTitleBar();
+    drawProfile();
+
+    auto& oversample = dynamic_cast<DSP::Signals::Oversample&>(**signal);
+    ImNodes::BeginStaticAttribute(id + StaticFactorAttrib);
+    static const char* factors[] = {"2x", "4x", "8x"};
+    int factor = std::countr_zero(oversample.getFactor()) - 1;
+    ImGui::SetNextItemWidth(100);
+    if(ImGui::Combo(("Factor##" + std::to_string(id)).c_str(), &factor, factors, IM_ARRAYSIZE(factors)))
+        oversample.setFactor(2u << factor);
     ImNodes::EndStaticAttribute();
 
+    ImNodes::BeginInputAttribute(id + InSignalAttrib);
+    ImGui::Text("Stage");
+    ImNodes::EndInputAttribute();
+
+    ImNodes::BeginOutputAttribute(id + OutSignalAttrib);
+    ImGui::Text("Value");
+    ImNodes::EndOutputAttribute();
+
+    ImNodes::EndNode();
+}
+
+GraphDesc::Node OversampleNode::getDesc() const
+{
+    GraphDesc::Node desc = NodeBase::getDesc();
+    desc.kind = std::countr_zero(dynamic_cast<const DSP::Signals::Oversample&>(**signal).getFactor()) - 1;
+    return desc;
+}
+
+void OversampleNode::setDesc(const GraphDesc::Node& desc)
+{
+    dynamic_cast<DSP::Signals::Oversample&>(**signal).setFactor(2u << std::clamp(desc.kind, 0, 2));
+}
+
+OversampleInputNode::OversampleInputNode() :
+    NodeBase()
+{
+    signal = std::make_shared<std::shared_ptr<DSP::Signals::SignalBase>>(std::make_shared<DSP::Signals::OversampleInput>());
+}
+
+void OversampleInputNode::Draw()
+{
+    ImNodes::BeginNode(id);
+
+    ImNodes::BeginNodeTitleBar();
+    ImGui::Text("Oversample input id %d", id);
+    ImNodes::EndNodeTitleBar();
+    drawProfile();
+
+    ImNodes::BeginInputAttribute(id + InSignalAttrib);
+    ImGui::Text("Signal");
+    ImNodes::EndInputAttribute();
+
+    ImNodes::BeginOutputAttribute(id + OutSignalAttrib);
+    ImGui::Text("Value x%u", dynamic_cast<const DSP::Signals::OversampleInput&>(**signal).getFactor());
+    ImNodes::EndOutputAttribute();
+
     ImNodes::EndNode();
 }
 
-bool OutputNode::GenerateSound()
+AutomationNode::AutomationNode() :
+    NodeBase()
+{
+    signal = std::make_shared<std::shared_ptr<DSP::Signals::SignalBase>>(std::make_shared<DSP::Signals::Automation>(
+        std::vector<DSP::Signals::Automation::Breakpoint>{{0.0, 0.0}, {1.0, 1.0}}
+    ));
+}
+
+void AutomationNode::Draw()
 {
-    if(signal)
+    ImNodes::BeginNode(id);
+
+    ImNodes::BeginNodeTitleBar();
+    ImGui::Text("Automation id %d", id);
+    ImNodes::EndNodeTitleBar();
+    drawProfile();
+
+    auto& automation = dynamic_cast<DSP::Signals::Automation&>(**signal);
+    auto points = automation.getPoints();
+    bool edited = false;
+
+    ImNodes::BeginStaticAttribute(id + StaticCurveAttrib);
+    if(ImPlot::BeginPlot(("Curve##" + std::to_string(id)).c_str(), ImVec2(300, 150)))
+    {
+        // A quarter past the last point shows where the curve holds
+        constexpr int cCurvePoints = 200;
+        const double seconds = points.empty() ? 1.0 : std::max(points.back().time * 1.25, 1.0);
+        DSP::Signals::Automation preview(points);
+        double times[cCurvePoints], values[cCurvePoints];
+        for(int i = 0; i < cCurvePoints; ++i)
+        {
+            times[i] = seconds * i / (cCurvePoints - 1);
+            values[i] = preview.get(times[i] * SAMPLE_RATE);
+        }
+        ImPlot::PlotLine("##curve", times, values, cCurvePoints);
+        for(size_t k = 0; k < points.size(); ++k)
+            edited |= ImPlot::DragPoint(static_cast<int>(k), &points[k].time, &points[k].value, ImVec4(0.9f, 0.4f, 0.1f, 1.0f));
+        ImPlot::EndPlot();
+    }
+
+    static const char* curves[] = {"Linear", "Exponential"};
+    for(size_t k = 0; k < points.size(); ++k)
     {
-        for(int i = 0; i < soundPoints.size(); ++i)
+        ImGui::PushID(static_cast<int>(k));
+        ImGui::SetNextItemWidth(70);
+        edited |= ImGui::InputDouble("s", &points[k].time);
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(70);
+        edited |= ImGui::InputDouble("##value", &points[k].value);
+        ImGui::SameLine();
+        int curve = static_cast<int>(points[k].curve);
+        ImGui::SetNextItemWidth(100);
+        if(ImGui::Combo("##curve", &curve, curves, IM_ARRAYSIZE(curves)))
         {
-            soundPoints[i] = (*signal)->get(i);
+            points[k].curve = static_cast<DSP::Signals::Automation::Curve>(curve);
+            edited = true;
         }
+        ImGui::SameLine();
+        if(ImGui::SmallButton("x"))
+        {
+            points.erase(points.begin() + k);
+            edited = true;
+            ImGui::PopID();
+            break;
+        }
+        ImGui::PopID();
+    }
+    if(ImGui::Button(("Add point##" + std::to_string(id)).c_str()))
+    {
+        points.push_back(points.empty() ? DSP::Signals::Automation::Breakpoint{} : DSP::Signals::Automation::Breakpoint{points.back().time + 1.0, points.back().value});
+        edited = true;
+    }
+    if(edited)
+        automation.setPoints(std::move(points));
+    ImNodes::EndStaticAttribute();
+
+    ImNodes::BeginOutputAttribute(id + OutValueAttrib);
+    ImGui::Text("Value");
+    ImNodes::EndOutputAttribute();
+
+    ImNodes::EndNode();
+}
+
+std::string AutomationNode::getText() const
+{
+    return DSP::Signals::Automation::Format(dynamic_cast<const DSP::Signals::Automation&>(**signal).getPoints());
+}
+
+void AutomationNode::setText(const std::string& text)
+{
+    if(auto points = DSP::Signals::Automation::Parse(text))
+        dynamic_cast<DSP::Signals::Automation&>(**signal).setPoints(std::move(*points));
+}
+
+FormulaNode::FormulaNode() :
+    NodeBase()
+{
+    signal = std::make_shared<std::shared_ptr<DSP::Signals::SignalBase>>(std::make_shared<DSP::Signals::Formula>());
+    setText("a");
+}
+
+void FormulaNode::Draw()
+{
+    ImNodes::BeginNode(id);
+
+    ImNodes::BeginNodeTitleBar();
+    ImGui::Text("Formula id %d", id);
+    ImNodes::EndNodeTitleBar();
+    drawProfile();
+
+    auto& formula = dynamic_cast<DSP::Signals::Formula&>(**signal);
+    ImNodes::BeginStaticAttribute(id + StaticFormulaAttrib);
+    ImGui::SetNextItemWidth(250);
+    if(ImGui::InputText(("##formula" + std::to_string(id)).c_str(), textBuffer, sizeof(textBuffer)))
+        setText(textBuffer);
+    if(!formula.getError().empty())
+        ImGui::TextColored(ImVec4(0.9f, 0.3f, 0.3f, 1.0f), "%s", formula.getError().c_str());
+    ImNodes::EndStaticAttribute();
+
+    for(size_t k = 0; k < inputs; ++k)
+    {
+        ImNodes::BeginInputAttribute(id + InFirstAttrib + static_cast<int>(k << 16));
+        ImGui::Text("%c", DSP::Signals::Bytecode::InputName(k));
+        ImNodes::EndInputAttribute();
     }
-    return true;
+
+    ImNodes::BeginOutputAttribute(id + OutValueAttrib);
+    ImGui::Text("Value");
+    ImNodes::EndOutputAttribute();
+
+    ImNodes::EndNode();
+}
+
+std::string FormulaNode::getText() const
+{
+    return dynamic_cast<const DSP::Signals::Formula&>(**signal).getText();
+}
+
+void FormulaNode::setText(const std::string& text)
+{
+    auto& formula = dynamic_cast<DSP::Signals::Formula&>(**signal);
+    if(formula.setText(text))
+        inputs = std::max<size_t>(formula.getProgram()->getInputs(), 1);
+    if(text != textBuffer)
+        std::strncpy(textBuffer, text.c_str(), sizeof(textBuffer) - 1);
 }
 
-} // namespace DSP
\ No newline at end of file
+} // namespace DSP
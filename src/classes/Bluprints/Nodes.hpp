@@ -2,9 +2,19 @@
 #define NODES_HPP
 
 #include <memory>
+#include <vector>
+#include <utility>
+#include <string>
 
 #include "NodeBase.hpp"
 #include "Signals/Signals.hpp"
+#include "FFT/Spectrum.hpp"
+#include "Signals/Convolution/Convolution.hpp"
+#include "Signals/Filter/Filter.hpp"
+#include "Signals/Oversample/Oversample.hpp"
+#include "Signals/Automation/Automation.hpp"
+#include "Signals/Formula/Formula.hpp"
+#include "Render/RenderQueue.hpp"
 
 #define NODE_CLASS_TYPE(type) static DSP::NodeType getStaticType() { return DSP::NodeType::type; }\
                                 DSP::NodeType getType() const override { return getStaticType(); }\
@@ -36,10 +46,15 @@ public:
     SignalNode();
     void Draw() override;
 
+    GraphDesc::Node getDesc() const override;
+    void setDesc(const GraphDesc::Node& desc) override;
+
     void updateSignalType();
 
     ~SignalNode() override = default;
 private:
+    // "k" checkbox switching an input between audio and control rate
+    void drawRateToggle(Signals::SignalData::Input input);
     ImPlotPoint plotFunc(int idx, void* user_data);
     bool isSignalTypeChanged = false;
     int signalType = 0;
@@ -59,6 +74,9 @@ public:
     FunctionNode();
     void Draw() override;
 
+    GraphDesc::Node getDesc() const override;
+    void setDesc(const GraphDesc::Node& desc) override;
+
     void updateFunctionType();
 
     ~FunctionNode() override = default;
@@ -78,6 +96,9 @@ public:
     ConstantNode(double value = 0.0);
     void Draw() override;
 
+    GraphDesc::Node getDesc() const override;
+    void setDesc(const GraphDesc::Node& desc) override;
+
     ~ConstantNode() override = default;
 private:
 };
@@ -91,20 +112,172 @@ public:
         InSignalAttrib = 0x00020000,
         StaticOutAttrib = 0x10000000
     };
-    OutputNode() : NodeBase(), soundPoints(SAMPLE_RATE * DURATION) {};
+    OutputNode() : NodeBase() {};
     void Draw() override;
-    bool GenerateSound();
+    // Play is handed to the editor's audio stream, which renders the graph block by block
+    bool takePlayRequest() { return std::exchange(playRequested, false); }
+    // Save is handed to the editor's render queue, which reports back through setSaveTask()
+    bool takeSaveRequest() { return std::exchange(saveRequested, false); }
+    void setSaveTask(std::shared_ptr<RenderTask> task) { saveTask = std::move(task); }
+    std::string getSavePath() const { return "output" + std::to_string(id) + ".wav"; }
+    // Saves stream to disk, so they can be any length
+    double getSaveSeconds() const { return saveSeconds; }
+
+    ~OutputNode() override = default;
+private:
+    void drawSaveTask();
 
-    void setSignal(std::shared_ptr<std::shared_ptr<DSP::Signals::SignalBase>>& signal) override
+    bool playRequested = false;
+    bool saveRequested = false;
+    float saveSeconds = DURATION;
+    std::shared_ptr<RenderTask> saveTask;
+};
+
+class SpectrumNode : public NodeBase
+{
+public:
+    NODE_CLASS_TYPE(Spectrum);
+    enum
     {
-        NodeBase::setSignal(signal);
-        isGenerated = false;
-    }
+        InSignalAttrib = 0x00020000,
+        StaticPlotAttrib = 0x10000000
+    };
+    SpectrumNode() : NodeBase() {};
+    void Draw() override;
 
-    ~OutputNode() override = default;
+    GraphDesc::Node getDesc() const override;
+    void setDesc(const GraphDesc::Node& desc) override;
+
+    ~SpectrumNode() override = default;
+private:
+    void updateSpectrum();
+    int sizeIndex = 2;
+    int windowType = 1;
+    std::unique_ptr<SpectrumAnalyzer> analyzer;
+    std::vector<float> samples;
+    std::vector<float> magnitudes;
+    std::vector<float> frequencies;
+};
+
+class ConvolutionNode : public NodeBase
+{
+public:
+    NODE_CLASS_TYPE(Convolution);
+    enum
+    {
+        OutSignalAttrib =   0x00010000,
+        StaticPathAttrib =  0x10000000,
+        InSignalAttrib =    0x00020000,
+    };
+    ConvolutionNode();
+    void Draw() override;
+
+    std::string getText() const override { return path; }
+    void setText(const std::string& text) override;
+
+    ~ConvolutionNode() override = default;
+private:
+    void loadKernel();
+    std::string path;
+    char pathBuffer[256] = {};
+};
+
+class FilterNode : public NodeBase
+{
+public:
+    NODE_CLASS_TYPE(Filter);
+    enum
+    {
+        OutSignalAttrib =   0x00010000,
+        StaticTypeAttrib =  0x10000000,
+        InSignalAttrib =    0x00020000,
+        InCutoffAttrib =    0x00030000,
+        InQAttrib =         0x00040000,
+        InGainAttrib =      0x00050000,
+    };
+    FilterNode();
+    void Draw() override;
+
+    GraphDesc::Node getDesc() const override;
+    void setDesc(const GraphDesc::Node& desc) override;
+
+    ~FilterNode() override = default;
+private:
+};
+
+class OversampleNode : public NodeBase
+{
+public:
+    NODE_CLASS_TYPE(Oversample);
+    enum
+    {
+        OutSignalAttrib =       0x00010000,
+        StaticFactorAttrib =    0x10000000,
+        InSignalAttrib =        0x00020000,
+    };
+    OversampleNode();
+    void Draw() override;
+
+    GraphDesc::Node getDesc() const override;
+    void setDesc(const GraphDesc::Node& desc) override;
+
+    ~OversampleNode() override = default;
+};
+
+class OversampleInputNode : public NodeBase
+{
+public:
+    NODE_CLASS_TYPE(OversampleInput);
+    enum
+    {
+        OutSignalAttrib =   0x00010000,
+        InSignalAttrib =    0x00020000,
+    };
+    OversampleInputNode();
+    void Draw() override;
+
+    ~OversampleInputNode() override = default;
+};
+
+class AutomationNode : public NodeBase
+{
+public:
+    NODE_CLASS_TYPE(Automation);
+    enum
+    {
+        OutValueAttrib =    0x00010000,
+        StaticCurveAttrib = 0x10000000,
+    };
+    AutomationNode();
+    void Draw() override;
+
+    // The breakpoints in the Automation::Parse() format
+    std::string getText() const override;
+    void setText(const std::string& text) override;
+
+    ~AutomationNode() override = default;
+};
+
+class FormulaNode : public NodeBase
+{
+public:
+    NODE_CLASS_TYPE(Formula);
+    enum
+    {
+        OutValueAttrib =        0x00010000,
+        StaticFormulaAttrib =   0x10000000,
+        InFirstAttrib =         0x00020000,     // input k at InFirstAttrib + (k << 16)
+    };
+    FormulaNode();
+    void Draw() override;
+
+    std::string getText() const override;
+    void setText(const std::string& text) override;
+
+    ~FormulaNode() override = default;
 private:
-    bool isGenerated = false;
-    std::vector<float> soundPoints;
+    char textBuffer[256] = {};
+    size_t inputs = 1;      // ports shown, kept from the last formula that compiled
 };
 
 }// namespace DSP
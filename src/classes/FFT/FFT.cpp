@@ -0,0 +1,179 @@
+#include "FFT.hpp"
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace DSP
+{
+FFT::FFT(size_t size) :
+    size(size),
+    half(size / 2),
+    bitReverse(half),
+    splitRe(half / 2 + 1),
+    splitIm(half / 2 + 1)
+{
+    unsigned bits = 0;
+    while((size_t(1) << bits) < half)
+        ++bits;
+    for(size_t i = 0; i < half; ++i)
+    {
+        unsigned reversed = 0;
+        for(unsigned b = 0; b < bits; ++b)
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        bitReverse[i] = reversed;
+    }
+
+    // Stage with butterfly span h uses exp(-2 pi i j / 2h) for j < h, stored back to back
+    for(size_t h = 1; h < half; h *= 2)
+    {
+        for(size_t j = 0; j < h; ++j)
+        {
+            double angle = -M_PI * j / h;
+            twiddleRe.push_back(static_cast<float>(std::cos(angle)));
+            twiddleIm.push_back(static_cast<float>(std::sin(angle)));
+        }
+    }
+    for(size_t k = 0; k < splitRe.size(); ++k)
+    {
+        double angle = -2.0 * M_PI * k / size;
+        splitRe[k] = static_cast<float>(std::cos(angle));
+        splitIm[k] = static_cast<float>(std::sin(angle));
+    }
+}
+
+const FFT& FFT::Get(size_t size)
+{
+    static std::mutex mutex;
+    static std::map<size_t, std::unique_ptr<FFT>> plans;
+    std::lock_guard lock(mutex);
+    auto& plan = plans[size];
+    if(!plan)
+        plan = std::make_unique<FFT>(size);
+    return *plan;
+}
+
+template<bool Inverse>
+void FFT::transform(float* re, float* im) const
+{
+    for(size_t i = 0; i < half; ++i)
+    {
+        size_t j = bitReverse[i];
+        if(i < j)
+        {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+
+    // First two stages fused as radix-4 butterflies, they have trivial twiddles
+    if(half >= 4)
+    {
+        for(size_t i = 0; i < half; i += 4)
+        {
+            float ar = re[i] + re[i + 1], ai = im[i] + im[i + 1];
+            float br = re[i] - re[i + 1], bi = im[i] - im[i + 1];
+            float cr = re[i + 2] + re[i + 3], ci = im[i + 2] + im[i + 3];
+            float dr = re[i + 2] - re[i + 3], di = im[i + 2] - im[i + 3];
+            // d * -i forward, d * i inverse
+            float tr = Inverse ? -di : di, ti = Inverse ? dr : -dr;
+            re[i] = ar + cr;        im[i] = ai + ci;
+            re[i + 2] = ar - cr;    im[i + 2] = ai - ci;
+            re[i + 1] = br + tr;    im[i + 1] = bi + ti;
+            re[i + 3] = br - tr;    im[i + 3] = bi - ti;
+        }
+    }
+    else if(half == 2)
+    {
+        float r = re[1], m = im[1];
+        re[1] = re[0] - r;  im[1] = im[0] - m;
+        re[0] += r;         im[0] += m;
+    }
+
+    const float* wRe = twiddleRe.data() + 3;
+    const float* wIm = twiddleIm.data() + 3;
+    for(size_t h = 4; h < half; h *= 2)
+    {
+        for(size_t group = 0; group < half; group += 2 * h)
+        {
+            float* __restrict aRe = re + group;
+            float* __restrict aIm = im + group;
+            float* __restrict bRe = re + group + h;
+            float* __restrict bIm = im + group + h;
+            for(size_t j = 0; j < h; ++j)
+            {
+                const float cr = wRe[j];
+                const float ci = Inverse ? -wIm[j] : wIm[j];
+                const float tr = bRe[j] * cr - bIm[j] * ci;
+                const float ti = bRe[j] * ci + bIm[j] * cr;
+                bRe[j] = aRe[j] - tr;
+                bIm[j] = aIm[j] - ti;
+                aRe[j] += tr;
+                aIm[j] += ti;
+            }
+        }
+        wRe += h;
+        wIm += h;
+    }
+}
+
+void FFT::forward(const float* in, float* re, float* im) const
+{
+    for(size_t n = 0; n < half; ++n)
+    {
+        re[n] = in[2 * n];
+        im[n] = in[2 * n + 1];
+    }
+    transform<false>(re, im);
+
+    // X[k] = E + W^k O with E = (Z[k] + conj Z[M-k]) / 2, O = (Z[k] - conj Z[M-k]) / 2i
+    const float z0r = re[0], z0i = im[0];
+    re[0] = z0r + z0i;
+    im[0] = 0.0f;
+    re[half] = z0r - z0i;
+    im[half] = 0.0f;
+    for(size_t k = 1; k <= half / 2; ++k)
+    {
+        const size_t m = half - k;
+        const float er = 0.5f * (re[k] + re[m]), ei = 0.5f * (im[k] - im[m]);
+        const float orr = 0.5f * (im[k] + im[m]), oi = -0.5f * (re[k] - re[m]);
+        const float wr = splitRe[k], wi = splitIm[k];
+        const float tr = wr * orr - wi * oi, ti = wr * oi + wi * orr;
+        re[k] = er + tr;
+        im[k] = ei + ti;
+        // X[M-k] = conj(E) - conj(W^k O)
+        re[m] = er - tr;
+        im[m] = ti - ei;
+    }
+}
+
+void FFT::inverse(float* re, float* im, float* out) const
+{
+    // Z[k] = E + i O with E = (X[k] + conj X[M-k]) / 2, O = (X[k] - conj X[M-k]) conj(W^k) / 2
+    const float x0 = re[0], xm = re[half];
+    re[0] = 0.5f * (x0 + xm);
+    im[0] = 0.5f * (x0 - xm);
+    for(size_t k = 1; k <= half / 2; ++k)
+    {
+        const size_t m = half - k;
+        const float er = 0.5f * (re[k] + re[m]), ei = 0.5f * (im[k] - im[m]);
+        const float dr = 0.5f * (re[k] - re[m]), di = 0.5f * (im[k] + im[m]);
+        const float wr = splitRe[k], wi = -splitIm[k];
+        const float orr = dr * wr - di * wi, oi = dr * wi + di * wr;
+        re[k] = er - oi;
+        im[k] = ei + orr;
+        re[m] = er + oi;
+        im[m] = orr - ei;
+    }
+    transform<true>(re, im);
+
+    const float scale = 1.0f / half;
+    for(size_t n = 0; n < half; ++n)
+    {
+        out[2 * n] = re[n] * scale;
+        out[2 * n + 1] = im[n] * scale;
+    }
+}
+}// namespace DSP
@@ -0,0 +1,45 @@
+#ifndef FFT_HPP
+#define FFT_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace DSP
+{
+/**
+ * @class FFT
+ * @brief Single precision real FFT of a power-of-two size
+ *
+ * A real transform of size N runs as one complex radix-2 transform of size N/2 on split
+ * real/imaginary arrays, so every butterfly stage is a contiguous loop the compiler vectorizes.
+ * Plans only hold read-only tables and are shared between threads through Get().
+ */
+class FFT
+{
+public:
+    FFT(size_t size);
+
+    // Cached plan for size, created on first use
+    static const FFT& Get(size_t size);
+    static bool isPowerOfTwo(size_t size) { return size >= 4 && (size & (size - 1)) == 0; }
+
+    size_t getSize() const { return size; }
+    size_t getBins() const { return size / 2 + 1; }
+
+    // in: size samples; re/im: getBins() values each
+    void forward(const float* in, float* re, float* im) const;
+    // Destroys re/im; out: size samples, scaled so inverse(forward(x)) == x
+    void inverse(float* re, float* im, float* out) const;
+private:
+    template<bool Inverse>
+    void transform(float* re, float* im) const;
+
+    size_t size;
+    size_t half;
+    std::vector<unsigned> bitReverse;
+    std::vector<float> twiddleRe, twiddleIm;   // stage twiddles of the half size complex FFT
+    std::vector<float> splitRe, splitIm;       // exp(-2 pi i k / size) for the real/complex split
+};
+}// namespace DSP
+
+#endif
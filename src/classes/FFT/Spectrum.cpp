@@ -0,0 +1,56 @@
+#include "Spectrum.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace DSP
+{
+static constexpr float cFloorDb = -140.0f;
+
+SpectrumAnalyzer::SpectrumAnalyzer(size_t size, Window window) :
+    fft(&FFT::Get(FFT::isPowerOfTwo(size) ? size : 2048)),
+    windowType(window),
+    window(getSize()),
+    windowed(getSize()),
+    re(getBins()),
+    im(getBins())
+{
+    const size_t n = getSize();
+    double sum = 0.0;
+    for(size_t i = 0; i < n; ++i)
+    {
+        const double t = 2.0 * M_PI * i / n;
+        double w = 1.0;
+        switch(window)
+        {
+            case Window::Rectangular:
+                break;
+            case Window::Hann:
+                w = 0.5 - 0.5 * std::cos(t);
+                break;
+            case Window::Blackman:
+                w = 0.42 - 0.5 * std::cos(t) + 0.08 * std::cos(2.0 * t);
+                break;
+        }
+        this->window[i] = static_cast<float>(w);
+        sum += w;
+    }
+    // Normalize by the coherent gain so a full-scale sine peaks at 0 dB
+    scale = static_cast<float>(2.0 / sum);
+}
+
+void SpectrumAnalyzer::analyze(const float* samples, float* magnitudesDb)
+{
+    const size_t n = getSize();
+    for(size_t i = 0; i < n; ++i)
+        windowed[i] = samples[i] * window[i];
+    fft->forward(windowed.data(), re.data(), im.data());
+
+    const size_t bins = getBins();
+    for(size_t k = 0; k < bins; ++k)
+    {
+        const float power = (re[k] * re[k] + im[k] * im[k]) * scale * scale;
+        magnitudesDb[k] = std::max(cFloorDb, 10.0f * std::log10(power + 1e-30f));
+    }
+}
+}// namespace DSP
@@ -0,0 +1,42 @@
+#ifndef SPECTRUM_HPP
+#define SPECTRUM_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "FFT.hpp"
+
+namespace DSP
+{
+/**
+ * @class SpectrumAnalyzer
+ * @brief Windowed magnitude spectrum in dBFS, a full-scale sine reads 0 dB
+ */
+class SpectrumAnalyzer
+{
+public:
+    enum class Window
+    {
+        Rectangular,
+        Hann,
+        Blackman
+    };
+
+    SpectrumAnalyzer(size_t size = 2048, Window window = Window::Hann);
+
+    size_t getSize() const { return fft->getSize(); }
+    size_t getBins() const { return fft->getBins(); }
+    Window getWindow() const { return windowType; }
+
+    // samples: getSize() values, magnitudesDb: getBins() values
+    void analyze(const float* samples, float* magnitudesDb);
+private:
+    const FFT* fft;
+    Window windowType;
+    std::vector<float> window;
+    std::vector<float> windowed, re, im;
+    float scale = 1.0f;
+};
+}// namespace DSP
+
+#endif
@@ -0,0 +1,290 @@
+#include "Graph.hpp"
+
+#include <print>
+#include <algorithm>
+#include <unordered_set>
+
+#include "Signals/Signals.hpp"
+#include "Signals/Convolution/Convolution.hpp"
+#include "Signals/Filter/Filter.hpp"
+#include "Signals/Oversample/Oversample.hpp"
+#include "Signals/Automation/Automation.hpp"
+#include "Signals/Formula/Formula.hpp"
+
+namespace DSP
+{
+uint8_t GraphDesc::Node::controlRate() const
+{
+    constexpr uint8_t cInputs = Signals::SignalData::Amplitude | Signals::SignalData::Frequency |
+        Signals::SignalData::Phase | Signals::SignalData::Duty;
+    if(!(value >= 0.0 && value <= 255.0))
+        return 0;
+    return static_cast<uint8_t>(value) & cInputs;
+}
+
+size_t GraphDesc::Node::sections() const
+{
+    if(!(value >= 1.0))
+        return 1;
+    return static_cast<size_t>(std::min(value, static_cast<double>(Signals::Filter::cMaxSections)));
+}
+
+const GraphDesc::Node* GraphDesc::findNode(uint32_t id) const
+{
+    auto iter = std::find_if(nodes.begin(), nodes.end(), [id](const Node& node) { return node.id == id; });
+    return iter != nodes.end() ? &*iter : nullptr;
+}
+
+const std::string& GraphDesc::getText(const Node& node) const
+{
+    static const std::string empty;
+    return node.text > 0 && node.text <= texts.size() ? texts[node.text - 1] : empty;
+}
+
+uint32_t GraphDesc::addText(std::string text)
+{
+    if(text.empty())
+        return 0;
+    texts.push_back(std::move(text));
+    return static_cast<uint32_t>(texts.size());
+}
+
+Graph::Graph(const GraphDesc& desc) :
+    desc(desc)
+{
+    std::unordered_map<uint32_t, NodeType> types;
+    types.reserve(desc.nodes.size());
+    signals.reserve(desc.nodes.size());
+    for(auto& node : desc.nodes)
+    {
+        types[node.id] = node.type;
+        SignalSlot slot;
+        switch(node.type)
+        {
+            case Signal:
+                slot = std::make_shared<std::shared_ptr<Signals::SignalBase>>(
+                    makeSignal(static_cast<SignalKind>(node.kind), Signals::SignalData())
+                );
+                (*slot)->getData().controlRate = node.controlRate();
+                break;
+            case Function:
+                slot = std::make_shared<std::shared_ptr<Signals::SignalBase>>(
+                    makeFunction(static_cast<FunctionKind>(node.kind), nullptr, nullptr)
+                );
+                break;
+            case Constant:
+                slot = std::make_shared<std::shared_ptr<Signals::SignalBase>>(
+                    std::make_shared<Signals::Constant>(node.value)
+                );
+                break;
+            case Output:
+                outputs.push_back(node.id);
+                break;
+            case Spectrum:
+                break;
+            case Convolution:
+            {
+                auto& path = desc.getText(node);
+                auto kernel = path.empty() ? nullptr : Signals::Convolution::LoadKernel(path);
+                slot = std::make_shared<std::shared_ptr<Signals::SignalBase>>(
+                    std::make_shared<Signals::Convolution>(std::move(kernel))
+                );
+                break;
+            }
+            case Filter:
+                slot = std::make_shared<std::shared_ptr<Signals::SignalBase>>(std::make_shared<Signals::Filter>(
+                    static_cast<Signals::Filter::Type>(node.kind),
+                    node.sections()
+                ));
+                break;
+            case Oversample:
+                slot = std::make_shared<std::shared_ptr<Signals::SignalBase>>(
+                    std::make_shared<Signals::Oversample>(2u << std::clamp(node.kind, 0, 2))
+                );
+                break;
+            case OversampleInput:
+                slot = std::make_shared<std::shared_ptr<Signals::SignalBase>>(std::make_shared<Signals::OversampleInput>());
+                break;
+            case Automation:
+            {
+                auto points = Signals::Automation::Parse(desc.getText(node));
+                slot = std::make_shared<std::shared_ptr<Signals::SignalBase>>(
+                    std::make_shared<Signals::Automation>(points.value_or(std::vector<Signals::Automation::Breakpoint>{}))
+                );
+                break;
+            }
+            case Formula:
+            {
+                auto formula = std::make_shared<Signals::Formula>();
+                if(!formula->setText(desc.getText(node)))
+                    std::print(stderr, "Invalid formula of node {}: {}\n", node.id, formula->getError());
+                slot = std::make_shared<std::shared_ptr<Signals::SignalBase>>(std::move(formula));
+                break;
+            }
+        }
+        signals[node.id] = std::move(slot);
+    }
+
+    for(auto& link : desc.links)
+    {
+        auto from = types.find(link.from);
+        auto to = types.find(link.to);
+        if(from == types.end() || to == types.end() || isSink(from->second))
+        {
+            std::print(stderr, "Skipping link {} -> {}: no such source or target\n", link.from, link.to);
+            continue;
+        }
+        if(!connect(to->second, link.port, signals[link.to], signals[link.from]))
+            std::print(stderr, "Skipping link {} -> {}: node has no input port {}\n", link.from, link.to, link.port);
+    }
+    adoptSignals();
+}
+
+void Graph::adoptSignals()
+{
+    std::unordered_set<const Signals::SignalBase*> visited;
+    std::vector<Signals::SignalBase*> stack;
+    for(auto& [id, slot] : signals)
+    {
+        if(slot && *slot)
+            stack.push_back(slot->get());
+    }
+    while(!stack.empty())
+    {
+        Signals::SignalBase* signal = stack.back();
+        stack.pop_back();
+        if(!visited.insert(signal).second)
+            continue;
+        signal->setPool(pool);
+        signal->visitInputs([&stack](const SignalSlot& input) {
+            if(input && *input)
+                stack.push_back(input->get());
+        });
+    }
+    Signals::SignalBase::StatefulMarks marks;
+    for(auto& [id, slot] : signals)
+    {
+        if(slot && *slot)
+            Signals::SignalBase::MarkStateful(**slot, marks);
+    }
+}
+
+std::shared_ptr<Signals::SignalBase> Graph::makeSignal(SignalKind kind, const Signals::SignalData& data)
+{
+    switch(kind)
+    {
+        case SignalKind::Sin:
+            return std::make_shared<Signals::Sin>(data);
+        case SignalKind::Cos:
+            return std::make_shared<Signals::Cos>(data);
+        case SignalKind::Pulse:
+            return std::make_shared<Signals::Pulse>(data);
+        case SignalKind::Sawtooth:
+            return std::make_shared<Signals::Sawtooth>(data);
+        case SignalKind::Triangle:
+            return std::make_shared<Signals::Triangle>(data);
+        case SignalKind::Noise:
+            return std::make_shared<Signals::Noise>(data);
+    }
+    return std::make_shared<Signals::Sin>(data);
+}
+
+std::shared_ptr<Signals::SignalBase> Graph::makeFunction(FunctionKind kind, SignalSlot&& left, SignalSlot&& right)
+{
+    switch(kind)
+    {
+        case FunctionKind::Sum:
+            return std::make_shared<Signals::SumParam>(std::move(left), std::move(right));
+        case FunctionKind::Mul:
+            return std::make_shared<Signals::MulParam>(std::move(left), std::move(right));
+        case FunctionKind::FreqModulator:
+            return std::make_shared<Signals::freqModulator>(std::move(left), std::move(right));
+    }
+    return std::make_shared<Signals::SumParam>(std::move(left), std::move(right));
+}
+
+bool Graph::connect(NodeType endType, uint32_t port, SignalSlot& endSignal, SignalSlot& source)
+{
+    switch(endType)
+    {
+        case Signal:
+            switch(port)
+            {
+                case AmplitudePort:
+                    (*endSignal)->getData().amplitude = source;
+                    return true;
+                case FrequencyPort:
+                    (*endSignal)->getData().freq = source;
+                    return true;
+                case PhasePort:
+                    (*endSignal)->getData().phase = source;
+                    return true;
+                case DutyPort:
+                    (*endSignal)->getData().d = source;
+                    return true;
+            }
+            return false;
+        case Function:
+            switch(port)
+            {
+                case LeftPort:
+                    dynamic_cast<Signals::ComplexSignal&>(**endSignal).SetLeft(source);
+                    return true;
+                case RightPort:
+                    dynamic_cast<Signals::ComplexSignal&>(**endSignal).SetRight(source);
+                    return true;
+            }
+            return false;
+        case Constant:
+        case Automation:
+            return false;
+        case Convolution:
+            if(port != SignalPort)
+                return false;
+            dynamic_cast<Signals::Convolution&>(**endSignal).setInput(source);
+            return true;
+        case Filter:
+        {
+            auto& filter = dynamic_cast<Signals::Filter&>(**endSignal);
+            switch(port)
+            {
+                case SignalPort:
+                    filter.setInput(source);
+                    return true;
+                case CutoffPort:
+                    filter.setFrequency(source);
+                    return true;
+                case QPort:
+                    filter.setQ(source);
+                    return true;
+                case GainPort:
+                    filter.setGain(source);
+                    return true;
+            }
+            return false;
+        }
+        case Oversample:
+            if(port != SignalPort)
+                return false;
+            dynamic_cast<Signals::Oversample&>(**endSignal).setInput(source);
+            return true;
+        case OversampleInput:
+            if(port != SignalPort)
+                return false;
+            dynamic_cast<Signals::OversampleInput&>(**endSignal).setInput(source);
+            return true;
+        case Formula:
+            if(port < FirstInputPort || port >= FirstInputPort + Signals::Formula::cMaxInputs)
+                return false;
+            dynamic_cast<Signals::Formula&>(**endSignal).setInput(port - FirstInputPort, source);
+            return true;
+        case Output:
+        case Spectrum:
+            if(port != SignalPort)
+                return false;
+            endSignal = source;
+            return true;
+    }
+    return false;
+}
+}// namespace DSP
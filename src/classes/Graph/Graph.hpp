@@ -0,0 +1,138 @@
+#ifndef GRAPH_HPP
+#define GRAPH_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include "Signals/SignalBase.hpp"
+#include "Signals/BufferPool/BufferPool.hpp"
+
+namespace DSP
+{
+enum NodeType : uint32_t
+{
+    Signal,
+    Function,
+    Constant,
+    Output,
+    Spectrum,
+    Convolution,
+    Filter,
+    Oversample,
+    OversampleInput,
+    Automation,
+    Formula
+};
+
+enum class SignalKind : int32_t
+{
+    Sin,
+    Cos,
+    Pulse,
+    Sawtooth,
+    Triangle,
+    Noise
+};
+
+enum class FunctionKind : int32_t
+{
+    Sum,
+    Mul,
+    FreqModulator
+};
+
+// Port numbers match the high 16 bits of the editor attribute ids
+enum Port : uint32_t
+{
+    OutPort = 1,
+    AmplitudePort = 2,
+    FrequencyPort = 3,
+    PhasePort = 4,
+    DutyPort = 5,
+    LeftPort = 2,
+    RightPort = 3,
+    SignalPort = 2,
+    CutoffPort = 3,
+    QPort = 4,
+    GainPort = 5,
+    FirstInputPort = 2     // Formula input a, b, c, ... follow
+};
+
+using SignalSlot = std::shared_ptr<std::shared_ptr<Signals::SignalBase>>;
+
+/**
+ * @brief Plain description of a node graph: what the editor shows, without any live signals
+ *
+ * Node and Link are also the on-disk records of the binary graph format, so their layout is fixed.
+ */
+struct GraphDesc
+{
+    struct Node
+    {
+        uint32_t id = 0;
+        NodeType type = Signal;
+        int32_t kind = 0;
+        uint32_t text = 0;      // index + 1 into texts, 0 when the node has none
+        double value = 0.0;     // Signal: SignalData::Input bits of the control rate inputs
+        float x = 0.0f, y = 0.0f;
+
+        // value read back as control rate bits or filter sections, out of range values can't reach the casts
+        uint8_t controlRate() const;
+        size_t sections() const;
+    };
+    struct Link
+    {
+        uint32_t from = 0;
+        uint32_t to = 0;
+        uint32_t port = 0;
+    };
+    static_assert(sizeof(Node) == 32 && offsetof(Node, value) == 16 && offsetof(Node, x) == 24);
+    static_assert(sizeof(Link) == 12);
+
+    const Node* findNode(uint32_t id) const;
+    const std::string& getText(const Node& node) const;
+    uint32_t addText(std::string text);
+
+    std::vector<Node> nodes;
+    std::vector<Link> links;
+    std::vector<std::string> texts;
+};
+
+/**
+ * @class Graph
+ * @brief Live signal graph built from a GraphDesc, usable without the editor
+ *
+ * Every signal of the graph draws its buffers from the graph's own BufferPool, so the memory of one
+ * render is counted, bounded by the pool's budget and freed together.
+ */
+class Graph
+{
+public:
+    Graph(const GraphDesc& desc);
+
+    static std::shared_ptr<Signals::SignalBase> makeSignal(SignalKind kind, const Signals::SignalData& data);
+    static std::shared_ptr<Signals::SignalBase> makeFunction(FunctionKind kind, SignalSlot&& left, SignalSlot&& right);
+    static bool connect(NodeType endType, uint32_t port, SignalSlot& endSignal, SignalSlot& source);
+    // Sinks take their input slot as their own signal and have no output port
+    static bool isSink(NodeType type) { return type == Output || type == Spectrum; }
+
+    bool hasNode(uint32_t id) const { return signals.contains(id); }
+    SignalSlot& getSignal(uint32_t id) { return signals.at(id); }
+    const std::vector<uint32_t>& getOutputs() const { return outputs; }
+    const GraphDesc& getDesc() const { return desc; }
+    const std::shared_ptr<Signals::BufferPool>& getPool() const { return pool; }
+    // Moves every signal reachable from the graph onto its pool and marks its stateful inputs, call after putting new signals into the slots
+    void adoptSignals();
+private:
+    GraphDesc desc;
+    std::shared_ptr<Signals::BufferPool> pool = std::make_shared<Signals::BufferPool>();
+    std::unordered_map<uint32_t, SignalSlot> signals;
+    std::vector<uint32_t> outputs;
+};
+}// namespace DSP
+
+#endif
@@ -0,0 +1,384 @@
+#include "GraphIO.hpp"
+
+#include <print>
+#include <fstream>
+#include <cstring>
+#include <bit>
+#include <cmath>
+
+#include "Json.hpp"
+#include "MappedFile.hpp"
+
+namespace DSP
+{
+static_assert(std::endian::native == std::endian::little, "binary graphs are stored little-endian");
+
+// Binary layout: BinaryHeader, nodeCount GraphDesc::Node records, linkCount GraphDesc::Link records.
+// Version 2 appends the text table: uint32_t count, then per text a uint32_t length and its bytes.
+struct BinaryHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t nodeCount;
+    uint32_t linkCount;
+};
+static_assert(sizeof(BinaryHeader) == 16);
+
+static const char* cTypeNames[] = {"Signal", "Function", "Constant", "Output", "Spectrum", "Convolution", "Filter", "Oversample", "OversampleInput", "Automation", "Formula"};
+static const char* cSignalKindNames[] = {"Sin", "Cos", "Pulse", "Sawtooth", "Triangle", "Noise"};
+static const char* cFunctionKindNames[] = {"Sum", "Mul", "Frequency Modulator"};
+static const char* cWindowNames[] = {"Rectangular", "Hann", "Blackman"};
+static const char* cFilterKindNames[] = {"LowPass", "HighPass", "BandPass", "Notch", "Peak", "LowShelf", "HighShelf"};
+static const char* cOversampleKindNames[] = {"2x", "4x", "8x"};
+// Bit i of a Signal node's value marks input cInputNames[i] as control rate
+static const char* cInputNames[] = {"Amplitude", "Frequency", "Phase", "Duty"};
+static_assert(Signals::SignalData::Amplitude == 1 && Signals::SignalData::Duty == 1 << 3);
+
+template<size_t N>
+static int32_t findName(const char* (&names)[N], const std::string& name)
+{
+    for(size_t i = 0; i < N; ++i)
+    {
+        if(name == names[i])
+            return static_cast<int32_t>(i);
+    }
+    return -1;
+}
+
+// Empty for an index outside names
+template<size_t N>
+static const char* nameAt(const char* (&names)[N], int32_t index)
+{
+    return index >= 0 && static_cast<size_t>(index) < N ? names[index] : "";
+}
+
+// Types whose kind indexes one of the name tables above
+static bool hasKind(NodeType type)
+{
+    return type == Signal || type == Function || type == Spectrum || type == Filter || type == Oversample;
+}
+
+const char* GraphIO::TypeName(NodeType type)
+{
+    return cTypeNames[type];
+}
+
+const char* GraphIO::KindName(NodeType type, int32_t kind)
+{
+    switch(type)
+    {
+        case Signal:
+            return nameAt(cSignalKindNames, kind);
+        case Function:
+            return nameAt(cFunctionKindNames, kind);
+        case Spectrum:
+            return nameAt(cWindowNames, kind);
+        case Filter:
+            return nameAt(cFilterKindNames, kind);
+        case Oversample:
+            return nameAt(cOversampleKindNames, kind);
+        default:
+            return "";
+    }
+}
+
+std::optional<GraphDesc> GraphIO::Load(const std::string& path)
+{
+    MappedFile file(path);
+    if(!file.isOpen())
+    {
+        std::print(stderr, "Failed to open graph: {}\n", path);
+        return std::nullopt;
+    }
+    auto data = file.getData();
+    std::optional<GraphDesc> desc;
+    if(data.size() >= sizeof(cMagic) && std::memcmp(data.data(), cMagic, sizeof(cMagic)) == 0)
+        desc = ParseBinary(data);
+    else
+        desc = ParseJson(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()));
+    if(!desc)
+        std::print(stderr, "Failed to load graph: {}\n", path);
+    return desc;
+}
+
+bool GraphIO::Save(const std::string& path, const GraphDesc& desc)
+{
+    std::ofstream file(path, std::ios::binary);
+    if(!file)
+    {
+        std::print(stderr, "Failed to create file: {}\n", path);
+        return false;
+    }
+    if(path.ends_with(".json"))
+        WriteJson(file, desc);
+    else
+        WriteBinary(file, desc);
+    return static_cast<bool>(file);
+}
+
+std::optional<GraphDesc> GraphIO::ParseBinary(std::span<const std::byte> data)
+{
+    BinaryHeader header;
+    if(data.size() < sizeof(header))
+    {
+        std::print(stderr, "Truncated graph header\n");
+        return std::nullopt;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if(std::memcmp(header.magic, cMagic, sizeof(cMagic)) != 0 || header.version == 0 || header.version > cVersion)
+    {
+        std::print(stderr, "Unsupported graph version {}\n", header.version);
+        return std::nullopt;
+    }
+    const size_t nodeBytes = size_t(header.nodeCount) * sizeof(GraphDesc::Node);
+    const size_t linkBytes = size_t(header.linkCount) * sizeof(GraphDesc::Link);
+    if(data.size() < sizeof(header) + nodeBytes + linkBytes)
+    {
+        std::print(stderr, "Truncated graph body\n");
+        return std::nullopt;
+    }
+
+    // Records are stored in their in-memory layout, so both tables are bulk copies
+    GraphDesc desc;
+    desc.nodes.resize(header.nodeCount);
+    desc.links.resize(header.linkCount);
+    std::memcpy(desc.nodes.data(), data.data() + sizeof(header), nodeBytes);
+    std::memcpy(desc.links.data(), data.data() + sizeof(header) + nodeBytes, linkBytes);
+
+    if(header.version >= 2)
+    {
+        auto rest = data.subspan(sizeof(header) + nodeBytes + linkBytes);
+        auto readCount = [&rest](uint32_t& value)
+        {
+            if(rest.size() < sizeof(value))
+                return false;
+            std::memcpy(&value, rest.data(), sizeof(value));
+            rest = rest.subspan(sizeof(value));
+            return true;
+        };
+        uint32_t count = 0;
+        // Every entry carries at least its length, which bounds the count before anything is reserved
+        if(!readCount(count) || count > rest.size() / sizeof(uint32_t))
+        {
+            std::print(stderr, "Truncated graph text table\n");
+            return std::nullopt;
+        }
+        desc.texts.reserve(count);
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t length = 0;
+            if(!readCount(length) || rest.size() < length)
+            {
+                std::print(stderr, "Truncated graph text table\n");
+                return std::nullopt;
+            }
+            desc.texts.emplace_back(reinterpret_cast<const char*>(rest.data()), length);
+            rest = rest.subspan(length);
+        }
+    }
+
+    for(auto& node : desc.nodes)
+    {
+        if(node.type > Formula)
+        {
+            std::print(stderr, "Invalid node type {} for node {}\n", static_cast<uint32_t>(node.type), node.id);
+            return std::nullopt;
+        }
+        if(hasKind(node.type) && *KindName(node.type, node.kind) == '\0')
+        {
+            std::print(stderr, "Invalid kind {} for node {}\n", node.kind, node.id);
+            return std::nullopt;
+        }
+        if(node.text > desc.texts.size())
+        {
+            std::print(stderr, "Invalid text index {} for node {}\n", node.text, node.id);
+            return std::nullopt;
+        }
+        if(!std::isfinite(node.value))
+        {
+            std::print(stderr, "Invalid value for node {}\n", node.id);
+            return std::nullopt;
+        }
+    }
+    return desc;
+}
+
+void GraphIO::WriteBinary(std::ostream& out, const GraphDesc& desc)
+{
+    BinaryHeader header;
+    std::memcpy(header.magic, cMagic, sizeof(cMagic));
+    header.version = cVersion;
+    header.nodeCount = static_cast<uint32_t>(desc.nodes.size());
+    header.linkCount = static_cast<uint32_t>(desc.links.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(desc.nodes.data()), desc.nodes.size() * sizeof(GraphDesc::Node));
+    out.write(reinterpret_cast<const char*>(desc.links.data()), desc.links.size() * sizeof(GraphDesc::Link));
+
+    const uint32_t count = static_cast<uint32_t>(desc.texts.size());
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for(auto& text : desc.texts)
+    {
+        const uint32_t length = static_cast<uint32_t>(text.size());
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(text.data(), length);
+    }
+}
+
+std::optional<GraphDesc> GraphIO::ParseJson(std::string_view text)
+{
+    std::string error;
+    auto root = Json::parse(text, &error);
+    if(!root)
+    {
+        std::print(stderr, "{}\n", error);
+        return std::nullopt;
+    }
+    if(root->numberOr("version", 0) > cVersion)
+    {
+        std::print(stderr, "Graph version {} is newer than supported {}\n", root->numberOr("version", 0), cVersion);
+        return std::nullopt;
+    }
+
+    GraphDesc desc;
+    if(auto* nodes = root->find("nodes"))
+    {
+        for(auto& item : nodes->array)
+        {
+            GraphDesc::Node node;
+            node.id = static_cast<uint32_t>(item.numberOr("id", 0));
+            int32_t type = findName(cTypeNames, item.stringOr("type", ""));
+            if(type < 0 || node.id == 0)
+            {
+                std::print(stderr, "Invalid node entry\n");
+                return std::nullopt;
+            }
+            node.type = static_cast<NodeType>(type);
+            // A missing kind falls back to the default, a misspelled or non-string one is an error like an unknown type
+            auto* kindValue = item.find("kind");
+            auto kindName = [kindValue](std::string_view fallback) {
+                return !kindValue ? std::string(fallback) : kindValue->type == Json::Value::Type::String ? kindValue->string : std::string();
+            };
+            if(node.type == Signal)
+                node.kind = findName(cSignalKindNames, kindName("Sin"));
+            else if(node.type == Function)
+                node.kind = findName(cFunctionKindNames, kindName("Sum"));
+            else if(node.type == Spectrum)
+                node.kind = findName(cWindowNames, kindName("Hann"));
+            else if(node.type == Filter)
+                node.kind = findName(cFilterKindNames, kindName("LowPass"));
+            else if(node.type == Oversample)
+                node.kind = findName(cOversampleKindNames, kindName("2x"));
+            if(node.kind < 0)
+            {
+                std::print(stderr, "Unknown kind {} for node {}\n", kindName(""), node.id);
+                return std::nullopt;
+            }
+            node.value = item.numberOr("value", 0.0);
+            if(!std::isfinite(node.value))
+            {
+                std::print(stderr, "Invalid value for node {}\n", node.id);
+                return std::nullopt;
+            }
+            if(auto* control = item.find("control"); control && node.type == Signal)
+            {
+                uint32_t inputs = 0;
+                for(auto& name : control->array)
+                {
+                    const int32_t input = findName(cInputNames, name.string);
+                    if(input < 0)
+                    {
+                        std::print(stderr, "Unknown control rate input {} for node {}\n", name.string, node.id);
+                        return std::nullopt;
+                    }
+                    inputs |= 1u << input;
+                }
+                node.value = inputs;
+            }
+            if(node.type == Convolution)
+                node.text = desc.addText(item.stringOr("path", ""));
+            else if(node.type == Automation)
+                node.text = desc.addText(item.stringOr("points", ""));
+            else if(node.type == Formula)
+                node.text = desc.addText(item.stringOr("formula", ""));
+            node.x = static_cast<float>(item.numberOr("x", 0.0));
+            node.y = static_cast<float>(item.numberOr("y", 0.0));
+            desc.nodes.push_back(node);
+        }
+    }
+    if(auto* links = root->find("links"))
+    {
+        for(auto& item : links->array)
+        {
+            desc.links.push_back({
+                static_cast<uint32_t>(item.numberOr("from", 0)),
+                static_cast<uint32_t>(item.numberOr("to", 0)),
+                static_cast<uint32_t>(item.numberOr("port", 0))
+            });
+        }
+    }
+    return desc;
+}
+
+void GraphIO::WriteJson(std::ostream& out, const GraphDesc& desc)
+{
+    out << "{\n  \"version\": " << cVersion << ",\n  \"nodes\": [";
+    for(size_t i = 0; i < desc.nodes.size(); ++i)
+    {
+        auto& node = desc.nodes[i];
+        out << (i ? ",\n" : "\n") << "    {\"id\": " << node.id << ", \"type\": ";
+        Json::writeString(out, TypeName(node.type));
+        if(hasKind(node.type))
+        {
+            out << ", \"kind\": ";
+            Json::writeString(out, KindName(node.type, node.kind));
+        }
+        if(node.type == Constant || node.type == Spectrum || node.type == Filter)
+        {
+            out << ", \"value\": ";
+            Json::writeNumber(out, node.value);
+        }
+        if(node.type == Signal && node.value != 0.0)
+        {
+            out << ", \"control\": [";
+            const uint32_t inputs = node.controlRate();
+            bool first = true;
+            for(size_t i = 0; i < std::size(cInputNames); ++i)
+            {
+                if(!(inputs & (1u << i)))
+                    continue;
+                out << (first ? "" : ", ");
+                Json::writeString(out, cInputNames[i]);
+                first = false;
+            }
+            out << "]";
+        }
+        if(node.type == Convolution)
+        {
+            out << ", \"path\": ";
+            Json::writeString(out, desc.getText(node));
+        }
+        else if(node.type == Automation)
+        {
+            out << ", \"points\": ";
+            Json::writeString(out, desc.getText(node));
+        }
+        else if(node.type == Formula)
+        {
+            out << ", \"formula\": ";
+            Json::writeString(out, desc.getText(node));
+        }
+        out << ", \"x\": ";
+        Json::writeNumber(out, node.x);
+        out << ", \"y\": ";
+        Json::writeNumber(out, node.y);
+        out << "}";
+    }
+    out << "\n  ],\n  \"links\": [";
+    for(size_t i = 0; i < desc.links.size(); ++i)
+    {
+        auto& link = desc.links[i];
+        out << (i ? ",\n" : "\n") << "    {\"from\": " << link.from << ", \"to\": " << link.to << ", \"port\": " << link.port << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+}// namespace DSP
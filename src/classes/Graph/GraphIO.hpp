@@ -0,0 +1,36 @@
+#ifndef GRAPHIO_HPP
+#define GRAPHIO_HPP
+
+#include <cstddef>
+#include <string>
+#include <optional>
+#include <ostream>
+#include <span>
+
+#include "Graph.hpp"
+
+namespace DSP
+{
+class GraphIO
+{
+public:
+    static constexpr uint32_t cVersion = 2;
+    static constexpr char cMagic[4] = {'D', 'S', 'P', 'G'};
+
+    // Loads either format, detected by the binary magic
+    static std::optional<GraphDesc> Load(const std::string& path);
+    // Writes JSON for *.json paths and the binary format otherwise
+    static bool Save(const std::string& path, const GraphDesc& desc);
+
+    static std::optional<GraphDesc> ParseJson(std::string_view text);
+    static void WriteJson(std::ostream& out, const GraphDesc& desc);
+
+    static std::optional<GraphDesc> ParseBinary(std::span<const std::byte> data);
+    static void WriteBinary(std::ostream& out, const GraphDesc& desc);
+
+    static const char* TypeName(NodeType type);
+    static const char* KindName(NodeType type, int32_t kind);
+};
+}// namespace DSP
+
+#endif
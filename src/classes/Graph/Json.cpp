@@ -0,0 +1,254 @@
+#include "Json.hpp"
+
+#include <charconv>
+#include <cctype>
+#include <algorithm>
+
+namespace DSP
+{
+namespace Json
+{
+    const Value* Value::find(std::string_view key) const
+    {
+        for(auto& [name, value] : object)
+        {
+            if(name == key)
+                return &value;
+        }
+        return nullptr;
+    }
+
+    double Value::numberOr(std::string_view key, double fallback) const
+    {
+        auto* value = find(key);
+        return value && value->type == Type::Number ? value->number : fallback;
+    }
+
+    std::string Value::stringOr(std::string_view key, std::string_view fallback) const
+    {
+        auto* value = find(key);
+        return value && value->type == Type::String ? value->string : std::string(fallback);
+    }
+
+    namespace
+    {
+        class Parser
+        {
+        public:
+            Parser(std::string_view text) : text(text) {}
+
+            bool parseDocument(Value& out)
+            {
+                if(!parseValue(out, 0))
+                    return false;
+                skipSpaces();
+                return pos == text.size() || fail("trailing characters");
+            }
+
+            std::string error;
+        private:
+            static constexpr int cMaxDepth = 64;
+
+            bool fail(const char* what)
+            {
+                error = std::string(what) + " at offset " + std::to_string(pos);
+                return false;
+            }
+
+            void skipSpaces()
+            {
+                while(pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos])))
+                    ++pos;
+            }
+
+            bool consume(std::string_view token)
+            {
+                if(text.substr(pos, token.size()) != token)
+                    return false;
+                pos += token.size();
+                return true;
+            }
+
+            bool parseValue(Value& out, int depth)
+            {
+                if(depth > cMaxDepth)
+                    return fail("nesting too deep");
+                skipSpaces();
+                if(pos >= text.size())
+                    return fail("unexpected end of input");
+
+                switch(text[pos])
+                {
+                    case '{':
+                        return parseObject(out, depth);
+                    case '[':
+                        return parseArray(out, depth);
+                    case '"':
+                        out.type = Value::Type::String;
+                        return parseString(out.string);
+                    case 't':
+                    case 'f':
+                        out.type = Value::Type::Bool;
+                        out.boolean = text[pos] == 't';
+                        return consume(out.boolean ? "true" : "false") || fail("invalid literal");
+                    case 'n':
+                        out.type = Value::Type::Null;
+                        return consume("null") || fail("invalid literal");
+                }
+                out.type = Value::Type::Number;
+                auto [end, ec] = std::from_chars(text.data() + pos, text.data() + text.size(), out.number);
+                if(ec != std::errc())
+                    return fail("invalid number");
+                pos = end - text.data();
+                return true;
+            }
+
+            bool parseString(std::string& out)
+            {
+                ++pos;
+                while(pos < text.size() && text[pos] != '"')
+                {
+                    char c = text[pos++];
+                    if(c != '\\')
+                    {
+                        out += c;
+                        continue;
+                    }
+                    if(pos >= text.size())
+                        break;
+                    switch(char esc = text[pos++])
+                    {
+                        case 'n': out += '\n'; break;
+                        case 't': out += '\t'; break;
+                        case 'r': out += '\r'; break;
+                        case 'b': out += '\b'; break;
+                        case 'f': out += '\f'; break;
+                        case 'u':
+                        {
+                            unsigned code = 0;
+                            auto [end, ec] = std::from_chars(text.data() + pos, text.data() + std::min(pos + 4, text.size()), code, 16);
+                            if(ec != std::errc() || end != text.data() + pos + 4)
+                                return fail("invalid escape");
+                            pos += 4;
+                            if(code < 0x80)
+                                out += static_cast<char>(code);
+                            else if(code < 0x800)
+                            {
+                                out += static_cast<char>(0xC0 | (code >> 6));
+                                out += static_cast<char>(0x80 | (code & 0x3F));
+                            }
+                            else
+                            {
+                                out += static_cast<char>(0xE0 | (code >> 12));
+                                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                                out += static_cast<char>(0x80 | (code & 0x3F));
+                            }
+                            break;
+                        }
+                        default: out += esc; break;
+                    }
+                }
+                if(pos >= text.size())
+                    return fail("unterminated string");
+                ++pos;
+                return true;
+            }
+
+            bool parseArray(Value& out, int depth)
+            {
+                out.type = Value::Type::Array;
+                ++pos;
+                skipSpaces();
+                if(consume("]"))
+                    return true;
+                while(true)
+                {
+                    if(!parseValue(out.array.emplace_back(), depth + 1))
+                        return false;
+                    skipSpaces();
+                    if(consume("]"))
+                        return true;
+                    if(!consume(","))
+                        return fail("expected ',' or ']'");
+                }
+            }
+
+            bool parseObject(Value& out, int depth)
+            {
+                out.type = Value::Type::Object;
+                ++pos;
+                skipSpaces();
+                if(consume("}"))
+                    return true;
+                while(true)
+                {
+                    skipSpaces();
+                    auto& [key, value] = out.object.emplace_back();
+                    if(pos >= text.size() || text[pos] != '"')
+                        return fail("expected key");
+                    if(!parseString(key))
+                        return false;
+                    skipSpaces();
+                    if(!consume(":"))
+                        return fail("expected ':'");
+                    if(!parseValue(value, depth + 1))
+                        return false;
+                    skipSpaces();
+                    if(consume("}"))
+                        return true;
+                    if(!consume(","))
+                        return fail("expected ',' or '}'");
+                }
+            }
+
+            std::string_view text;
+            size_t pos = 0;
+        };
+    }
+
+    std::optional<Value> parse(std::string_view text, std::string* error)
+    {
+        Parser parser(text);
+        Value result;
+        if(!parser.parseDocument(result))
+        {
+            if(error)
+                *error = parser.error;
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    void writeString(std::ostream& out, std::string_view str)
+    {
+        out << '"';
+        for(char c : str)
+        {
+            switch(c)
+            {
+                case '"': out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\t': out << "\\t"; break;
+                case '\r': out << "\\r"; break;
+                default: out << c; break;
+            }
+        }
+        out << '"';
+    }
+
+    void writeNumber(std::ostream& out, double value)
+    {
+        char buffer[32];
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.write(buffer, end - buffer);
+    }
+
+    void writeNumber(std::ostream& out, float value)
+    {
+        char buffer[32];
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.write(buffer, end - buffer);
+    }
+}// namespace Json
+}// namespace DSP
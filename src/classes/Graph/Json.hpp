@@ -0,0 +1,50 @@
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <ostream>
+
+namespace DSP
+{
+namespace Json
+{
+    /**
+     * @brief Minimal JSON document, enough for patches, manifests and reports
+     */
+    struct Value
+    {
+        enum class Type
+        {
+            Null,
+            Bool,
+            Number,
+            String,
+            Array,
+            Object
+        };
+
+        const Value* find(std::string_view key) const;
+        double numberOr(std::string_view key, double fallback) const;
+        std::string stringOr(std::string_view key, std::string_view fallback) const;
+
+        Type type = Type::Null;
+        bool boolean = false;
+        double number = 0.0;
+        std::string string;
+        std::vector<Value> array;
+        std::vector<std::pair<std::string, Value>> object;
+    };
+
+    std::optional<Value> parse(std::string_view text, std::string* error = nullptr);
+
+    void writeString(std::ostream& out, std::string_view str);
+    void writeNumber(std::ostream& out, double value);
+    void writeNumber(std::ostream& out, float value);
+}// namespace Json
+}// namespace DSP
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <span>
+
+namespace DSP
+{
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a whole file
+ */
+class MappedFile
+{
+public:
+    MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    bool isOpen() const { return data != nullptr; }
+    std::span<const std::byte> getData() const { return {static_cast<const std::byte*>(data), size}; }
+private:
+    const void* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+};
+}// namespace DSP
+
+#endif
@@ -0,0 +1,94 @@
+#include "FastMath.hpp"
+
+#include <chrono>
+#include <vector>
+
+namespace DSP
+{
+namespace FastMath
+{
+static constexpr size_t cReportPoints = 1 << 16;
+static constexpr size_t cReportBuffer = 4096;
+static constexpr int cReportRepeats = 200;
+
+const char* GetName(Accuracy accuracy)
+{
+    switch(accuracy)
+    {
+    case Accuracy::High: return "high";
+    case Accuracy::Fast: return "fast";
+    default: return "exact";
+    }
+}
+
+template<class T>
+static const char* typeName() { return std::is_same_v<T, float> ? "float" : "double"; }
+
+// Max error against the long double std:: function, relative when `relative` is set
+template<class T, class Func, class Reference>
+static double measureError(Func&& func, Reference&& reference, double from, double to, bool relative)
+{
+    double worst = 0.0;
+    for(size_t i = 0; i < cReportPoints; ++i)
+    {
+        const T x = static_cast<T>(from + (to - from) * double(i) / (cReportPoints - 1));
+        const long double expected = reference(static_cast<long double>(x));
+        long double error = std::abs(static_cast<long double>(func(x)) - expected);
+        if(relative)
+            error /= std::abs(expected);
+        worst = std::max(worst, static_cast<double>(error));
+    }
+    return worst;
+}
+
+// Nanoseconds per value of func run over a buffer, the way block loops call it
+template<class T, class Func>
+static double measureSpeed(Func&& func, double from, double to)
+{
+    std::vector<T> in(cReportBuffer), out(cReportBuffer);
+    for(size_t i = 0; i < cReportBuffer; ++i)
+        in[i] = static_cast<T>(from + (to - from) * double(i) / cReportBuffer);
+    [[maybe_unused]] volatile T sink = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for(int repeat = 0; repeat < cReportRepeats; ++repeat)
+    {
+        for(size_t i = 0; i < cReportBuffer; ++i)
+            out[i] = func(in[i]);
+        sink = out[repeat % cReportBuffer];
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / (double(cReportBuffer) * cReportRepeats);
+}
+
+template<Accuracy A, class T>
+static void reportTier(std::ostream& out)
+{
+    auto row = [&out](const char* name, double error, double speed) {
+        out << name << ',' << GetName(A) << ',' << typeName<T>() << ',' << error << ',' << speed << '\n';
+    };
+    auto sinFunc = [](T x) { return sin<A>(x); };
+    auto cosFunc = [](T x) { return cos<A>(x); };
+    auto expFunc = [](T x) { return exp<A>(x); };
+    auto tanhFunc = [](T x) { return tanh<A>(x); };
+    row("sin", measureError<T>(sinFunc, [](long double x) { return std::sin(x); }, -1000.0, 1000.0, false), measureSpeed<T>(sinFunc, -1000.0, 1000.0));
+    row("cos", measureError<T>(cosFunc, [](long double x) { return std::cos(x); }, -1000.0, 1000.0, false), measureSpeed<T>(cosFunc, -1000.0, 1000.0));
+    row("exp", measureError<T>(expFunc, [](long double x) { return std::exp(x); }, -20.0, 20.0, true), measureSpeed<T>(expFunc, -20.0, 20.0));
+    row("tanh", measureError<T>(tanhFunc, [](long double x) { return std::tanh(x); }, -10.0, 10.0, false), measureSpeed<T>(tanhFunc, -10.0, 10.0));
+}
+
+template<class T>
+static void reportType(std::ostream& out)
+{
+    reportTier<Accuracy::Exact, T>(out);
+    reportTier<Accuracy::High, T>(out);
+    reportTier<Accuracy::Fast, T>(out);
+}
+
+void WriteReport(std::ostream& out)
+{
+    out << "function,accuracy,type,max_error,ns_per_value\n";
+    reportType<double>(out);
+    reportType<float>(out);
+}
+}// namespace FastMath
+}// namespace DSP
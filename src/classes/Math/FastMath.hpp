@@ -0,0 +1,215 @@
+#ifndef FASTMATH_HPP
+#define FASTMATH_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <bit>
+#include <type_traits>
+#include <algorithm>
+#include <ostream>
+
+namespace DSP
+{
+// Error budget of the transcendental functions used by the block engine
+enum class Accuracy : uint8_t
+{
+    Exact,  // the std:: functions, the per-sample get() path matches bit for bit except where a cached period loops
+    High,   // about 1e-7 absolute, at or below float rounding
+    Fast    // about 1e-4 absolute, fine for previews and modulation sources
+};
+
+/**
+ * @brief Branch-free approximations of sin/cos/exp/tanh and the rounding helpers they need
+ *
+ * Everything is inline and made of adds, multiplies, compares and bit casts, so loops over
+ * block buffers vectorize without SSE4.1 rounding instructions or libm calls. Both sides of
+ * every select are computed up front, otherwise the compiler keeps the branch to avoid
+ * speculating floating point operations.
+ * Polynomials are minimax fits: sin on [-pi/2, pi/2] after folding, 2^f on [-1/2, 1/2].
+ */
+namespace FastMath
+{
+    template<class T>
+    struct Constants;
+
+    template<>
+    struct Constants<double>
+    {
+        static constexpr double cRoundMagic = 0x1.8p52;    // adding it leaves no fraction bits
+        static constexpr double cStepScale = 0x1p60;        // turns any positive rounding difference into >= 1
+        static constexpr int64_t cExponentBias = 1023;
+        static constexpr int cMantissaBits = 52;
+        static constexpr double cExpMin = -708.0;
+        static constexpr double cExpMax = 709.0;
+        static constexpr double cLn2Hi = 6.93147180369123816490e-01;
+        static constexpr double cLn2Lo = 1.90821492927058770002e-10;
+        static constexpr double cTwoPiHi = 6.2831853069365025;     // 33 bits, n * cTwoPiHi is exact below n = 2^20
+        static constexpr double cTwoPiMid = 2.430840202602477e-10;
+        static constexpr double cTwoPiLo = 1.40862394607328e-26;
+        using Bits = uint64_t;
+    };
+
+    template<>
+    struct Constants<float>
+    {
+        static constexpr float cRoundMagic = 0x1.8p23f;
+        static constexpr float cStepScale = 0x1p30f;
+        static constexpr int32_t cExponentBias = 127;
+        static constexpr int cMantissaBits = 23;
+        static constexpr float cExpMin = -87.0f;
+        static constexpr float cExpMax = 88.0f;
+        static constexpr float cLn2Hi = 6.9314575195e-01f;
+        static constexpr float cLn2Lo = 1.4286067653e-06f;
+        static constexpr float cTwoPiHi = 6.28125f;                 // 12 bits, n * cTwoPiHi is exact below n = 2^12
+        static constexpr float cTwoPiMid = 0.0019353071693331003f;
+        static constexpr float cTwoPiLo = 1.0253376273028358e-11f;
+        using Bits = uint32_t;
+    };
+
+    constexpr long double cTwoPi = 6.283185307179586476925286766559L;
+    constexpr long double cPi = cTwoPi / 2;
+    constexpr long double cHalfPi = cTwoPi / 4;
+
+    // Round half to even, like std::nearbyint in the default rounding mode, for |x| below 2^51 (double) or 2^22 (float)
+    template<class T>
+    inline T round(T x)
+    {
+        using C = Constants<T>;
+        return (x + C::cRoundMagic) - C::cRoundMagic;
+    }
+
+    // Rounds toward zero, same range as round()
+    template<class T>
+    inline T trunc(T x)
+    {
+        using C = Constants<T>;
+        const T magnitude = std::abs(x);
+        const T r = round(magnitude);
+        // r > magnitude means rounding went up; the difference is then at least one ulp of 1/2
+        const T down = std::min(r, r - std::min((r - magnitude) * C::cStepScale, T(1)));
+        return std::copysign(down, x);
+    }
+
+    // x - y * trunc(x / y), the sign follows x as with std::fmod
+    template<Accuracy A, class T>
+    inline T fmod(T x, T y)
+    {
+        if constexpr(A == Accuracy::Exact)
+            return std::fmod(x, y);
+        else
+            return x - y * trunc(x / y);
+    }
+
+    // x reduced to [-pi, pi], with 2 pi split in three parts so large arguments keep their phase
+    template<Accuracy A, class T>
+    inline T wrap(T x)
+    {
+        if constexpr(A == Accuracy::Exact)
+            return std::remainder(x, T(cTwoPi));
+        else
+        {
+            using C = Constants<T>;
+            const T n = round(x * T(1 / cTwoPi));
+            return ((x - n * C::cTwoPiHi) - n * C::cTwoPiMid) - n * C::cTwoPiLo;
+        }
+    }
+
+    namespace Detail
+    {
+        // Saturation bounds of exp(), deliberately not constexpr: with constant bounds GCC's PRE
+        // splits the clamped path into a branch and the loop no longer vectorizes
+        template<class T>
+        inline T expMin = Constants<T>::cExpMin;
+        template<class T>
+        inline T expMax = Constants<T>::cExpMax;
+
+        // sin of r in [-pi, 3/2 pi], folded onto [-pi/2, pi/2] through sin(pi - r) == sin(r)
+        template<Accuracy A, class T>
+        inline T sinReduced(T r)
+        {
+            r = std::max(std::min(r, T(cPi) - r), -T(cPi) - r);
+            const T r2 = r * r;
+            if constexpr(A == Accuracy::High)
+                return r * (T(0.999999976589647862114) + r2 * (T(-0.166666476344786050072) + r2 * (T(0.00833289982053201043766)
+                    + r2 * (T(-0.000198008975857498166968) + r2 * T(2.59048813777395314757e-06)))));
+            else
+                return r * (T(0.999696769947992653889) + r2 * (T(-0.165673072163473967871) + r2 * T(0.0075143742278458147681)));
+        }
+
+        // 2^f for f in [-1/2, 1/2], constant term pinned to 1 so exp(0) == 1 and tanh(0) == 0
+        template<Accuracy A, class T>
+        inline T exp2Reduced(T f)
+        {
+            if constexpr(A == Accuracy::High)
+                return T(1) + f * (T(0.693147206248664346159) + f * (T(0.240226513459240345716) + f * (T(0.0555032779029200929203)
+                    + f * (T(0.00961800388886897570453) + f * (T(0.00134002700186511596679) + f * T(0.000154763005273960221099))))));
+            else
+                return T(1) + f * (T(0.693112493431085910649) + f * (T(0.242225522824004934811) + f * T(0.0559771517419320235145)));
+        }
+
+        // 2^n for an integral n inside the normal exponent range, built directly in the exponent bits
+        template<class T>
+        inline T pow2(T n)
+        {
+            using C = Constants<T>;
+            using Bits = typename C::Bits;
+            // The low mantissa bits of n + cRoundMagic hold n in two's complement
+            const Bits biased = std::bit_cast<Bits>(n + C::cRoundMagic) - std::bit_cast<Bits>(C::cRoundMagic) + Bits(C::cExponentBias);
+            return std::bit_cast<T>(Bits(biased << C::cMantissaBits));
+        }
+    }
+
+    template<Accuracy A, class T>
+    inline T sin(T x)
+    {
+        if constexpr(A == Accuracy::Exact)
+            return std::sin(x);
+        else
+            return Detail::sinReduced<A>(wrap<A>(x));
+    }
+
+    template<Accuracy A, class T>
+    inline T cos(T x)
+    {
+        if constexpr(A == Accuracy::Exact)
+            return std::cos(x);
+        else
+            return Detail::sinReduced<A>(wrap<A>(x) + T(cHalfPi));
+    }
+
+    // Relative error; the argument saturates where the result would leave the normal range
+    template<Accuracy A, class T>
+    inline T exp(T x)
+    {
+        if constexpr(A == Accuracy::Exact)
+            return std::exp(x);
+        else
+        {
+            using C = Constants<T>;
+            x = std::min(std::max(x, Detail::expMin<T>), Detail::expMax<T>);
+            const T n = round(x * T(M_LOG2E));
+            const T r = (x - n * C::cLn2Hi) - n * C::cLn2Lo;
+            return Detail::exp2Reduced<A>(r * T(M_LOG2E)) * Detail::pow2(n);
+        }
+    }
+
+    template<Accuracy A, class T>
+    inline T tanh(T x)
+    {
+        if constexpr(A == Accuracy::Exact)
+            return std::tanh(x);
+        else
+        {
+            // exp() saturates, so large arguments still come out as +-1 instead of inf / inf
+            const T e = exp<A>(T(2) * x);
+            return (e - T(1)) / (e + T(1));
+        }
+    }
+
+    const char* GetName(Accuracy accuracy);
+    // Measured max error and throughput of every function, tier and sample type as a table
+    void WriteReport(std::ostream& out);
+}// namespace FastMath
+}// namespace DSP
+
+#endif
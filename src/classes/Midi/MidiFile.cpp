@@ -0,0 +1,254 @@
+#include "MidiFile.hpp"
+
+#include <print>
+#include <cstring>
+#include <algorithm>
+
+#include "Graph/MappedFile.hpp"
+
+namespace DSP
+{
+static constexpr uint32_t cDefaultTempo = 500000;     // microseconds per quarter note, 120 bpm
+
+namespace
+{
+// Big-endian cursor over a chunk; reads past the end fail instead of throwing
+class MidiReader
+{
+public:
+    MidiReader(std::span<const std::byte> data) : data(data) {}
+
+    bool atEnd() const { return position >= data.size(); }
+    bool has(size_t count) const { return data.size() - position >= count; }
+    size_t getPosition() const { return position; }
+    void skip(size_t count) { position += std::min(count, data.size() - position); }
+
+    bool read(uint32_t& value, size_t bytes)
+    {
+        if(!has(bytes))
+            return false;
+        value = 0;
+        for(size_t i = 0; i < bytes; ++i)
+            value = (value << 8) | std::to_integer<uint32_t>(data[position++]);
+        return true;
+    }
+    bool readVariable(uint32_t& value)
+    {
+        value = 0;
+        for(int i = 0; i < 4; ++i)
+        {
+            uint32_t byte;
+            if(!read(byte, 1))
+                return false;
+            value = (value << 7) | (byte & 0x7F);
+            if(!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+    bool readTag(const char (&tag)[5])
+    {
+        if(!has(4) || std::memcmp(data.data() + position, tag, 4) != 0)
+            return false;
+        position += 4;
+        return true;
+    }
+    std::span<const std::byte> take(size_t count)
+    {
+        count = std::min(count, data.size() - position);
+        auto chunk = data.subspan(position, count);
+        position += count;
+        return chunk;
+    }
+private:
+    std::span<const std::byte> data;
+    size_t position = 0;
+};
+
+struct TimedEvent
+{
+    uint64_t tick;
+    MidiFile::Event event;
+};
+
+struct TempoChange
+{
+    uint64_t tick;
+    uint32_t microsecondsPerQuarter;
+};
+}
+
+static bool parseTrack(std::span<const std::byte> chunk, std::vector<TimedEvent>& events, std::vector<TempoChange>& tempos)
+{
+    MidiReader reader(chunk);
+    uint64_t tick = 0;
+    uint32_t status = 0;
+    while(!reader.atEnd())
+    {
+        uint32_t delta, byte;
+        if(!reader.readVariable(delta) || !reader.read(byte, 1))
+            return false;
+        tick += delta;
+        if(byte == 0xFF)
+        {
+            uint32_t type, length;
+            if(!reader.read(type, 1) || !reader.readVariable(length) || !reader.has(length))
+                return false;
+            if(type == 0x2F)
+                return true;
+            if(type == 0x51 && length == 3)
+            {
+                uint32_t tempo = cDefaultTempo;
+                reader.read(tempo, 3);
+                tempos.push_back({tick, tempo});
+            }
+            else
+                reader.skip(length);
+            continue;
+        }
+        if(byte == 0xF0 || byte == 0xF7)
+        {
+            uint32_t length;
+            if(!reader.readVariable(length) || !reader.has(length))
+                return false;
+            reader.skip(length);
+            continue;
+        }
+
+        uint32_t first;
+        if(byte & 0x80)
+        {
+            status = byte;
+            if(!reader.read(first, 1))
+                return false;
+        }
+        else if(status)
+            first = byte;           // running status
+        else
+            return false;
+
+        const uint32_t kind = status & 0xF0;
+        uint32_t second = 0;
+        if(kind != 0xC0 && kind != 0xD0 && !reader.read(second, 1))
+            return false;
+
+        MidiFile::Event event;
+        event.channel = static_cast<uint8_t>(status & 0x0F);
+        event.number = static_cast<uint8_t>(first & 0x7F);
+        event.value = static_cast<uint8_t>(second & 0x7F);
+        if(kind == 0x90)
+            event.type = event.value ? MidiFile::EventType::NoteOn : MidiFile::EventType::NoteOff;
+        else if(kind == 0x80)
+            event.type = MidiFile::EventType::NoteOff;
+        else if(kind == 0xB0)
+            event.type = MidiFile::EventType::Controller;
+        else
+            continue;
+        events.push_back({tick, event});
+    }
+    return true;
+}
+
+std::optional<std::vector<MidiFile::Event>> MidiFile::Parse(std::span<const std::byte> data)
+{
+    MidiReader reader(data);
+    uint32_t headerLength, format, trackCount, division;
+    if(!reader.readTag("MThd") || !reader.read(headerLength, 4) || headerLength < 6 ||
+        !reader.read(format, 2) || !reader.read(trackCount, 2) || !reader.read(division, 2))
+    {
+        std::print(stderr, "Not a Standard MIDI File\n");
+        return std::nullopt;
+    }
+    if(format > 1)
+    {
+        std::print(stderr, "MIDI file format {} is not supported\n", format);
+        return std::nullopt;
+    }
+    reader.skip(headerLength - 6);
+
+    std::vector<TimedEvent> events;
+    std::vector<TempoChange> tempos;
+    for(uint32_t track = 0; track < trackCount && !reader.atEnd();)
+    {
+        const bool isTrack = reader.readTag("MTrk");
+        if(!isTrack)
+            reader.skip(4);
+        uint32_t length;
+        if(!reader.read(length, 4) || !reader.has(length))
+        {
+            std::print(stderr, "Truncated MIDI chunk\n");
+            return std::nullopt;
+        }
+        auto chunk = reader.take(length);
+        if(!isTrack)
+            continue;
+        if(!parseTrack(chunk, events, tempos))
+        {
+            std::print(stderr, "Malformed MIDI track {}\n", track);
+            return std::nullopt;
+        }
+        ++track;
+    }
+
+    // Tracks are merged by tick; the stable sort keeps file order for simultaneous events
+    std::stable_sort(events.begin(), events.end(), [](const TimedEvent& a, const TimedEvent& b) { return a.tick < b.tick; });
+    std::stable_sort(tempos.begin(), tempos.end(), [](const TempoChange& a, const TempoChange& b) { return a.tick < b.tick; });
+
+    std::vector<Event> result;
+    result.reserve(events.size());
+    if(division & 0x8000)
+    {
+        // SMPTE time: frames per second in the high byte as a negative number, ticks per frame in the low one
+        const int framesPerSecond = -static_cast<int8_t>(division >> 8);
+        const uint32_t ticksPerFrame = division & 0xFF;
+        if(framesPerSecond <= 0 || ticksPerFrame == 0)
+        {
+            std::print(stderr, "Invalid MIDI time division\n");
+            return std::nullopt;
+        }
+        for(auto& [tick, event] : events)
+        {
+            event.seconds = double(tick) / (double(framesPerSecond) * ticksPerFrame);
+            result.push_back(event);
+        }
+        return result;
+    }
+    if(division == 0)
+    {
+        std::print(stderr, "Invalid MIDI time division\n");
+        return std::nullopt;
+    }
+
+    size_t nextTempo = 0;
+    uint64_t tempoTick = 0;
+    double tempoSeconds = 0.0;
+    double secondsPerTick = cDefaultTempo * 1e-6 / division;
+    for(auto& [tick, event] : events)
+    {
+        while(nextTempo < tempos.size() && tempos[nextTempo].tick <= tick)
+        {
+            tempoSeconds += double(tempos[nextTempo].tick - tempoTick) * secondsPerTick;
+            tempoTick = tempos[nextTempo].tick;
+            secondsPerTick = tempos[nextTempo].microsecondsPerQuarter * 1e-6 / division;
+            ++nextTempo;
+        }
+        event.seconds = tempoSeconds + double(tick - tempoTick) * secondsPerTick;
+        result.push_back(event);
+    }
+    return result;
+}
+
+std::optional<std::vector<MidiFile::Event>> MidiFile::Load(const std::string& path)
+{
+    MappedFile file(path);
+    if(!file.isOpen())
+    {
+        std::print(stderr, "Failed to open MIDI file: {}\n", path);
+        return std::nullopt;
+    }
+    auto events = Parse(file.getData());
+    if(!events)
+        std::print(stderr, "Failed to load MIDI file: {}\n", path);
+    return events;
+}
+}// namespace DSP
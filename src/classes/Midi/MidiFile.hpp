@@ -0,0 +1,43 @@
+#ifndef MIDIFILE_HPP
+#define MIDIFILE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <optional>
+#include <span>
+
+namespace DSP
+{
+/**
+ * @class MidiFile
+ * @brief Reader of Standard MIDI Files (format 0 and 1) down to timed note and controller events
+ *
+ * Every track is merged into one list ordered by time; events at the same tick keep file order.
+ * Tempo changes are applied while converting ticks to seconds, everything else is skipped.
+ */
+class MidiFile
+{
+public:
+    enum class EventType : uint8_t
+    {
+        NoteOn,
+        NoteOff,    // also note on with velocity 0
+        Controller
+    };
+    struct Event
+    {
+        double seconds = 0.0;
+        EventType type = EventType::NoteOn;
+        uint8_t channel = 0;
+        uint8_t number = 0;     // note or controller number
+        uint8_t value = 0;      // velocity or controller value
+    };
+
+    static std::optional<std::vector<Event>> Load(const std::string& path);
+    static std::optional<std::vector<Event>> Parse(std::span<const std::byte> data);
+};
+}// namespace DSP
+
+#endif
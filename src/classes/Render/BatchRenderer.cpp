@@ -0,0 +1,116 @@
+#include "BatchRenderer.hpp"
+
+#include <print>
+#include <cmath>
+#include <atomic>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+
+extern const uint32_t SAMPLE_RATE;
+
+namespace DSP
+{
+template<class T>
+static bool parseNumber(std::string_view str, T& value)
+{
+    auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc() && end == str.data() + str.size();
+}
+
+BatchRenderer::BatchRenderer(ThreadPool& pool, size_t maxConcurrent) :
+    pool(pool),
+    maxConcurrent(maxConcurrent ? maxConcurrent : pool.getSize())
+{
+}
+
+std::vector<RenderResult> BatchRenderer::run(const std::vector<RenderJob>& jobs)
+{
+    std::vector<RenderResult> results(jobs.size());
+    std::atomic<size_t> next = 0;
+
+    // Every finished job starts the next one, so at most maxConcurrent are alive at once
+    std::function<void()> worker = [&]() {
+        size_t index = next++;
+        if(index >= jobs.size())
+            return;
+        results[index] = jobs[index].run();
+        auto& result = results[index];
+        if(result.ok)
+            std::print(stderr, "[{}/{}] {} -> {}: load {:.1f} ms, render {:.1f} ms{}\n",
+                index + 1, jobs.size(), jobs[index].graphPath, jobs[index].outputPath,
+                result.loadSeconds * 1e3, result.renderSeconds * 1e3, result.cached ? " (cached)" : "");
+        else
+            std::print(stderr, "[{}/{}] {} failed: {}\n", index + 1, jobs.size(), jobs[index].graphPath, result.error);
+        pool.submit(worker);
+    };
+
+    for(size_t i = 0; i < std::min(maxConcurrent, jobs.size()); ++i)
+        pool.submit(worker);
+    pool.wait();
+    return results;
+}
+
+std::optional<std::vector<RenderJob>> BatchRenderer::LoadManifest(const std::string& path, double defaultDuration)
+{
+    std::ifstream file(path);
+    if(!file)
+    {
+        std::print(stderr, "Failed to open manifest: {}\n", path);
+        return std::nullopt;
+    }
+
+    std::vector<RenderJob> jobs;
+    std::string line;
+    for(int lineNumber = 1; std::getline(file, line); ++lineNumber)
+    {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        RenderJob job;
+        job.duration = defaultDuration;
+        if(!(fields >> job.graphPath))
+            continue;
+        if(!(fields >> job.outputPath) || job.outputPath == "-")
+        {
+            std::print(stderr, "{}:{}: expected '<graph> <output> [duration] [node]'\n", path, lineNumber);
+            return std::nullopt;
+        }
+        std::string duration, node, extra;
+        if(fields >> duration &&
+            (!parseNumber(duration, job.duration) || !std::isfinite(job.duration) || job.duration <= 0.0))
+        {
+            std::print(stderr, "{}:{}: invalid duration '{}'\n", path, lineNumber, duration);
+            return std::nullopt;
+        }
+        if(fields >> node && !parseNumber(node, job.node))
+        {
+            std::print(stderr, "{}:{}: invalid node '{}'\n", path, lineNumber, node);
+            return std::nullopt;
+        }
+        if(fields >> extra)
+        {
+            std::print(stderr, "{}:{}: unexpected '{}' after '<graph> <output> [duration] [node]'\n", path, lineNumber, extra);
+            return std::nullopt;
+        }
+        job.raw = job.outputPath.ends_with(".raw") || job.outputPath.ends_with(".pcm");
+        jobs.push_back(std::move(job));
+    }
+    return jobs;
+}
+
+void BatchRenderer::WriteReport(std::ostream& out, const std::vector<RenderJob>& jobs, const std::vector<RenderResult>& results)
+{
+    out << "graph,output,ok,samples,load_ms,render_ms,realtime_factor,cached,peak_bytes,over_budget,error\n";
+    for(size_t i = 0; i < jobs.size(); ++i)
+    {
+        auto& result = results[i];
+        double audioSeconds = static_cast<double>(result.samples) / SAMPLE_RATE;
+        double factor = result.renderSeconds > 0.0 ? audioSeconds / result.renderSeconds : 0.0;
+        out << jobs[i].graphPath << ',' << jobs[i].outputPath << ',' << result.ok << ','
+            << result.samples << ',' << result.loadSeconds * 1e3 << ',' << result.renderSeconds * 1e3 << ','
+            << factor << ',' << result.cached << ',' << result.peakBytes << ',' << result.overBudget << ',' << result.error << '\n';
+    }
+}
+}// namespace DSP
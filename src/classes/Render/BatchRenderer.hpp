@@ -0,0 +1,37 @@
+#ifndef BATCHRENDERER_HPP
+#define BATCHRENDERER_HPP
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <ostream>
+
+#include "RenderJob.hpp"
+#include "ThreadPool.hpp"
+
+namespace DSP
+{
+/**
+ * @class BatchRenderer
+ * @brief Runs many render jobs on a shared pool with a cap on how many are in flight
+ *
+ * Each job streams its output in chunks, so memory grows with the number of
+ * concurrent jobs, not with the render lengths.
+ */
+class BatchRenderer
+{
+public:
+    BatchRenderer(ThreadPool& pool, size_t maxConcurrent = 0);
+
+    std::vector<RenderResult> run(const std::vector<RenderJob>& jobs);
+
+    // Manifest lines: <graph> <output> [duration seconds] [output node id], '#' starts a comment
+    static std::optional<std::vector<RenderJob>> LoadManifest(const std::string& path, double defaultDuration);
+    static void WriteReport(std::ostream& out, const std::vector<RenderJob>& jobs, const std::vector<RenderResult>& results);
+private:
+    ThreadPool& pool;
+    size_t maxConcurrent;
+};
+}// namespace DSP
+
+#endif
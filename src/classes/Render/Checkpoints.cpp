@@ -0,0 +1,79 @@
+#include "Checkpoints.hpp"
+
+#include <unordered_set>
+
+namespace DSP
+{
+Checkpoints::Checkpoints(const SignalSlot& root, int64_t interval) :
+    interval(interval)
+{
+    // Depth first over the inputs, so the node order only depends on the graph's structure
+    std::unordered_set<const Signals::SignalBase*> visited;
+    std::vector<Signals::SignalBase*> stack;
+    if(root && *root)
+        stack.push_back(root->get());
+    while(!stack.empty())
+    {
+        Signals::SignalBase* signal = stack.back();
+        stack.pop_back();
+        if(!visited.insert(signal).second)
+            continue;
+        if(signal->isStateful())
+            nodes.push_back(signal);
+        signal->visitInputs([&stack](const SignalSlot& input) {
+            if(input && *input)
+                stack.push_back(input->get());
+        });
+    }
+}
+
+void Checkpoints::record(int64_t position)
+{
+    if(nodes.empty() || position <= 0)
+        return;
+    auto next = states.upper_bound(position);
+    if(next != states.begin() && position - std::prev(next)->first < interval)
+        return;
+
+    std::vector<Signals::StateBuffer> snapshot(nodes.size());
+    for(size_t i = 0; i < nodes.size(); ++i)
+        nodes[i]->saveState(snapshot[i]);
+    states[position] = std::move(snapshot);
+    if(states.size() <= cMaxCheckpoints)
+        return;
+    // Every other one goes and the interval doubles, so memory stays flat however long the render
+    bool keep = false;
+    for(auto state = states.begin(); state != states.end();)
+        state = (keep = !keep) ? std::next(state) : states.erase(state);
+    interval *= 2;
+}
+
+int64_t Checkpoints::latest(int64_t sample) const
+{
+    auto next = states.upper_bound(sample);
+    return next == states.begin() ? 0 : std::prev(next)->first;
+}
+
+int64_t Checkpoints::restore(int64_t sample)
+{
+    auto next = states.upper_bound(sample);
+    if(next == states.begin())
+        return 0;
+    auto& snapshot = std::prev(next)->second;
+    for(size_t i = 0; i < nodes.size(); ++i)
+    {
+        snapshot[i].rewind();
+        nodes[i]->loadState(snapshot[i]);
+    }
+    return std::prev(next)->first;
+}
+
+size_t Checkpoints::getMemoryUsage() const
+{
+    size_t bytes = 0;
+    for(auto& [position, snapshot] : states)
+        for(auto& state : snapshot)
+            bytes += state.size();
+    return bytes;
+}
+}// namespace DSP
@@ -0,0 +1,48 @@
+#ifndef CHECKPOINTS_HPP
+#define CHECKPOINTS_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include "Graph/Graph.hpp"
+
+namespace DSP
+{
+/**
+ * @class Checkpoints
+ * @brief Periodic state snapshots of every stateful signal reachable from a root slot
+ *
+ * A render records one at most every `interval` samples. Seeking restores the latest
+ * checkpoint before the target and pre-rolls from there instead of replaying from sample 0.
+ * Past cMaxCheckpoints they are thinned out to twice the interval, so long renders keep a fixed number.
+ */
+class Checkpoints
+{
+public:
+    static constexpr int64_t cDefaultInterval = 1 << 15;
+    static constexpr size_t cMaxCheckpoints = 64;
+
+    Checkpoints(const SignalSlot& root, int64_t interval = cDefaultInterval);
+
+    bool isStateful() const { return !nodes.empty(); }
+    int64_t getInterval() const { return interval; }
+
+    // Called at a block boundary; keeps a snapshot if none is within one interval before position
+    void record(int64_t position);
+    // Position of the latest checkpoint at or before sample, 0 when there is none
+    int64_t latest(int64_t sample) const;
+    // Restores latest(sample) and returns its position; at 0 the signals restart on their own
+    int64_t restore(int64_t sample);
+    void clear() { states.clear(); }
+
+    size_t getMemoryUsage() const;
+private:
+    std::vector<Signals::SignalBase*> nodes;
+    std::map<int64_t, std::vector<Signals::StateBuffer>> states;
+    int64_t interval;
+};
+}// namespace DSP
+
+#endif
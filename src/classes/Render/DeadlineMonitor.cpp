@@ -0,0 +1,107 @@
+#include "DeadlineMonitor.hpp"
+
+#include <print>
+#include <fstream>
+#include <algorithm>
+
+#include "Graph/Json.hpp"
+
+namespace DSP
+{
+void DeadlineMonitor::reset(uint32_t blockFrames, uint32_t sampleRate)
+{
+    this->blockFrames = blockFrames;
+    this->sampleRate = sampleRate;
+    deadlineNanoseconds = sampleRate ? uint64_t(blockFrames) * 1'000'000'000 / sampleRate : 0;
+    started = Clock::now();
+    for(auto* counter : {&blocks, &overruns, &xruns, &lastNanoseconds, &totalNanoseconds, &peakNanoseconds})
+        counter->store(0, std::memory_order_relaxed);
+    for(auto& bin : histogram)
+        bin.store(0, std::memory_order_relaxed);
+    for(auto& time : xrunTimes)
+        time.store(0, std::memory_order_relaxed);
+}
+
+void DeadlineMonitor::recordBlock(uint64_t nanoseconds)
+{
+    const double load = deadlineNanoseconds ? double(nanoseconds) / double(deadlineNanoseconds) : 0.0;
+    const size_t bin = std::min(static_cast<size_t>(load / cBinWidth), cBins - 1);
+    histogram[bin].fetch_add(1, std::memory_order_relaxed);
+    if(nanoseconds > deadlineNanoseconds)
+        overruns.fetch_add(1, std::memory_order_relaxed);
+    if(nanoseconds > peakNanoseconds.load(std::memory_order_relaxed))
+        peakNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+    lastNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+    totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    // Last, with release, so a snapshot that sees the block count also sees its time
+    blocks.fetch_add(1, std::memory_order_release);
+}
+
+void DeadlineMonitor::recordXrun()
+{
+    const uint64_t since = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - started).count();
+    const uint64_t index = xruns.load(std::memory_order_relaxed);
+    xrunTimes[index % cMaxXruns].store(since, std::memory_order_relaxed);
+    xruns.store(index + 1, std::memory_order_release);
+}
+
+DeadlineMonitor::Snapshot DeadlineMonitor::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.blockFrames = blockFrames;
+    snapshot.sampleRate = sampleRate;
+    snapshot.blocks = blocks.load(std::memory_order_acquire);
+    snapshot.xruns = xruns.load(std::memory_order_acquire);
+    snapshot.overruns = overruns.load(std::memory_order_relaxed);
+    if(deadlineNanoseconds)
+    {
+        const double deadline = double(deadlineNanoseconds);
+        snapshot.load = double(lastNanoseconds.load(std::memory_order_relaxed)) / deadline;
+        snapshot.peakLoad = double(peakNanoseconds.load(std::memory_order_relaxed)) / deadline;
+        if(snapshot.blocks)
+            snapshot.meanLoad = double(totalNanoseconds.load(std::memory_order_relaxed)) / deadline / double(snapshot.blocks);
+    }
+    for(size_t i = 0; i < cBins; ++i)
+        snapshot.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+    const uint64_t kept = std::min<uint64_t>(snapshot.xruns, cMaxXruns);
+    for(uint64_t i = snapshot.xruns - kept; i < snapshot.xruns; ++i)
+        snapshot.xrunSeconds.push_back(double(xrunTimes[i % cMaxXruns].load(std::memory_order_relaxed)) * 1e-9);
+    return snapshot;
+}
+
+void DeadlineMonitor::WriteJson(std::ostream& out, const Snapshot& snapshot)
+{
+    out << "{\n  \"block_frames\": " << snapshot.blockFrames << ",\n  \"sample_rate\": " << snapshot.sampleRate
+        << ",\n  \"deadline_ms\": ";
+    Json::writeNumber(out, snapshot.deadlineSeconds() * 1e3);
+    out << ",\n  \"blocks\": " << snapshot.blocks << ",\n  \"overruns\": " << snapshot.overruns
+        << ",\n  \"xruns\": " << snapshot.xruns << ",\n  \"mean_load\": ";
+    Json::writeNumber(out, snapshot.meanLoad);
+    out << ",\n  \"peak_load\": ";
+    Json::writeNumber(out, snapshot.peakLoad);
+    out << ",\n  \"xrun_seconds\": [";
+    for(size_t i = 0; i < snapshot.xrunSeconds.size(); ++i)
+    {
+        out << (i ? ", " : "");
+        Json::writeNumber(out, snapshot.xrunSeconds[i]);
+    }
+    out << "],\n  \"load_bin_width\": ";
+    Json::writeNumber(out, cBinWidth);
+    out << ",\n  \"load_histogram\": [";
+    for(size_t i = 0; i < cBins; ++i)
+        out << (i ? ", " : "") << snapshot.histogram[i];
+    out << "]\n}\n";
+}
+
+bool DeadlineMonitor::Save(const std::string& path, const Snapshot& snapshot)
+{
+    std::ofstream file(path);
+    if(!file)
+    {
+        std::print(stderr, "Failed to create file: {}\n", path);
+        return false;
+    }
+    WriteJson(file, snapshot);
+    return file.good();
+}
+}// namespace DSP
@@ -0,0 +1,78 @@
+#ifndef DEADLINEMONITOR_HPP
+#define DEADLINEMONITOR_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace DSP
+{
+/**
+ * @class DeadlineMonitor
+ * @brief Render time of every audio block against the block's real time deadline
+ *
+ * The audio thread is the only writer and never blocks or allocates: counters are relaxed
+ * atomics, xrun timestamps go to a fixed ring. Any other thread may take a snapshot() at
+ * any time; a snapshot taken mid-update can be one block behind, never torn per counter.
+ */
+class DeadlineMonitor
+{
+public:
+    static constexpr size_t cBins = 40;             // load histogram, the last bin also holds everything above
+    static constexpr double cBinWidth = 0.05;       // 5% of the deadline per bin
+    static constexpr size_t cMaxXruns = 256;        // most recent xrun timestamps kept
+
+    struct Snapshot
+    {
+        uint32_t blockFrames = 0;
+        uint32_t sampleRate = 0;
+        uint64_t blocks = 0;
+        uint64_t overruns = 0;          // blocks that took longer than their deadline
+        uint64_t xruns = 0;             // times the output ran dry
+        double load = 0.0;              // last block, 1.0 is the whole deadline
+        double meanLoad = 0.0;
+        double peakLoad = 0.0;
+        std::array<uint64_t, cBins> histogram{};
+        std::vector<double> xrunSeconds;    // since reset(), oldest first
+
+        double deadlineSeconds() const { return sampleRate ? double(blockFrames) / sampleRate : 0.0; }
+    };
+
+    DeadlineMonitor(uint32_t blockFrames = 0, uint32_t sampleRate = 0) { reset(blockFrames, sampleRate); }
+
+    // Not safe while the audio thread records
+    void reset(uint32_t blockFrames, uint32_t sampleRate);
+
+    // Audio thread only
+    void recordBlock(uint64_t nanoseconds);
+    void recordXrun();
+
+    Snapshot snapshot() const;
+
+    static void WriteJson(std::ostream& out, const Snapshot& snapshot);
+    static bool Save(const std::string& path, const Snapshot& snapshot);
+private:
+    using Clock = std::chrono::steady_clock;
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+    uint32_t blockFrames = 0;
+    uint32_t sampleRate = 0;
+    uint64_t deadlineNanoseconds = 0;
+    Clock::time_point started;
+    std::atomic<uint64_t> blocks = 0;
+    std::atomic<uint64_t> overruns = 0;
+    std::atomic<uint64_t> xruns = 0;
+    std::atomic<uint64_t> lastNanoseconds = 0;
+    std::atomic<uint64_t> totalNanoseconds = 0;
+    std::atomic<uint64_t> peakNanoseconds = 0;
+    std::array<std::atomic<uint64_t>, cBins> histogram;
+    std::array<std::atomic<uint64_t>, cMaxXruns> xrunTimes;   // ns since reset(), indexed by xrun count
+};
+}// namespace DSP
+
+#endif
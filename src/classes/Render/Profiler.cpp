@@ -0,0 +1,107 @@
+#include "Profiler.hpp"
+
+#include <print>
+#include <fstream>
+
+#include "Graph/GraphIO.hpp"
+#include "Graph/Json.hpp"
+
+namespace DSP
+{
+std::vector<ProfileEntry> Profiler::Collect(Graph& graph)
+{
+    std::vector<ProfileEntry> entries;
+    for(auto& node : graph.getDesc().nodes)
+    {
+        if(Graph::isSink(node.type) || !graph.hasNode(node.id))
+            continue;
+        auto& slot = graph.getSignal(node.id);
+        if(!slot || !*slot)
+            continue;
+        ProfileEntry entry;
+        entry.id = node.id;
+        entry.type = GraphIO::TypeName(node.type);
+        if(auto* counters = (*slot)->getProfile())
+            entry.counters = *counters;
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+void Profiler::Reset(Graph& graph)
+{
+    for(auto& node : graph.getDesc().nodes)
+    {
+        if(!graph.hasNode(node.id))
+            continue;
+        auto& slot = graph.getSignal(node.id);
+        if(slot && *slot)
+        {
+            if(auto* counters = (*slot)->getProfile())
+                counters->reset();
+        }
+    }
+}
+
+uint64_t Profiler::TotalNanoseconds(const std::vector<ProfileEntry>& entries)
+{
+    uint64_t total = 0;
+    for(auto& entry : entries)
+        total += entry.counters.nanoseconds;
+    return total;
+}
+
+static double share(const ProfileEntry& entry, uint64_t total)
+{
+    return total ? 100.0 * double(entry.counters.nanoseconds) / double(total) : 0.0;
+}
+
+void Profiler::WriteCSV(std::ostream& out, const std::vector<ProfileEntry>& entries)
+{
+    const uint64_t total = TotalNanoseconds(entries);
+    out << "id,type,calls,samples,ns,ns_per_sample,graph_percent,allocations,fallback_samples,shared_reads\n";
+    for(auto& entry : entries)
+    {
+        auto& counters = entry.counters;
+        out << entry.id << ',' << entry.type << ',' << counters.calls << ',' << counters.samples << ','
+            << counters.nanoseconds << ',' << counters.nanosecondsPerSample() << ',' << share(entry, total) << ','
+            << counters.allocations << ',' << counters.fallbackSamples << ',' << counters.sharedReads << '\n';
+    }
+}
+
+void Profiler::WriteJson(std::ostream& out, const std::vector<ProfileEntry>& entries)
+{
+    const uint64_t total = TotalNanoseconds(entries);
+    out << "{\n  \"enabled\": " << (cEnabled ? "true" : "false") << ",\n  \"total_ns\": " << total << ",\n  \"nodes\": [";
+    for(size_t i = 0; i < entries.size(); ++i)
+    {
+        auto& entry = entries[i];
+        auto& counters = entry.counters;
+        out << (i ? ",\n" : "\n") << "    {\"id\": " << entry.id << ", \"type\": ";
+        Json::writeString(out, entry.type);
+        out << ", \"calls\": " << counters.calls << ", \"samples\": " << counters.samples
+            << ", \"ns\": " << counters.nanoseconds << ", \"ns_per_sample\": ";
+        Json::writeNumber(out, counters.nanosecondsPerSample());
+        out << ", \"graph_percent\": ";
+        Json::writeNumber(out, share(entry, total));
+        out << ", \"allocations\": " << counters.allocations << ", \"fallback_samples\": " << counters.fallbackSamples
+            << ", \"shared_reads\": " << counters.sharedReads << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+bool Profiler::Save(const std::string& path, const std::vector<ProfileEntry>& entries)
+{
+    std::ofstream file(path);
+    if(!file)
+    {
+        std::print(stderr, "Failed to create file: {}\n", path);
+        return false;
+    }
+    if(path.ends_with(".json"))
+        WriteJson(file, entries);
+    else
+        WriteCSV(file, entries);
+    return file.good();
+}
+}// namespace DSP
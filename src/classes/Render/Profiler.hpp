@@ -0,0 +1,49 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "Graph/Graph.hpp"
+
+namespace DSP
+{
+struct ProfileEntry
+{
+    uint32_t id = 0;
+    std::string type;
+    Signals::ProfileCounters counters;
+};
+
+/**
+ * @class Profiler
+ * @brief Collects the per-node block engine counters of a graph and exports them
+ *
+ * Counting only happens in builds configured with DSP_PROFILE; otherwise every node reads zero
+ * and the engine carries no timing code at all. A node's share is its exclusive time over the
+ * sum of all nodes, so shares add up to 100%.
+ */
+class Profiler
+{
+public:
+#ifdef DSP_PROFILE
+    static constexpr bool cEnabled = true;
+#else
+    static constexpr bool cEnabled = false;
+#endif
+
+    // Every node with its own signal, sinks skipped since they share their input's
+    static std::vector<ProfileEntry> Collect(Graph& graph);
+    static void Reset(Graph& graph);
+    static uint64_t TotalNanoseconds(const std::vector<ProfileEntry>& entries);
+
+    static void WriteCSV(std::ostream& out, const std::vector<ProfileEntry>& entries);
+    static void WriteJson(std::ostream& out, const std::vector<ProfileEntry>& entries);
+    // JSON for *.json paths, CSV otherwise
+    static bool Save(const std::string& path, const std::vector<ProfileEntry>& entries);
+};
+}// namespace DSP
+
+#endif
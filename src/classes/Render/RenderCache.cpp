@@ -0,0 +1,217 @@
+#include "RenderCache.hpp"
+
+#include <print>
+#include <format>
+#include <fstream>
+#include <cstring>
+#include <typeinfo>
+#include <functional>
+#include <filesystem>
+#include <thread>
+
+extern const uint32_t SAMPLE_RATE;
+
+namespace DSP
+{
+// Bumped whenever the engine's output changes, so older disk entries stop matching.
+// 2: fixed point oscillator phase, Oversample rates, Filter coefficients on the control grid in every block
+static constexpr uint32_t cFormatVersion = 2;
+static constexpr char cMagic[4] = {'D', 'S', 'P', 'C'};
+
+static constexpr uint64_t cFnvOffset = 0xCBF29CE484222325ull;
+static constexpr uint64_t cFnvPrime = 0x100000001B3ull;
+
+static uint64_t mix(uint64_t seed, uint64_t value)
+{
+    for(int i = 0; i < 8; ++i)
+        seed = (seed ^ ((value >> (i * 8)) & 0xFF)) * cFnvPrime;
+    return seed;
+}
+
+// Type names are stable across runs of one build, unlike type_info addresses and hash_code()
+static uint64_t typeHash(const Signals::SignalBase& signal)
+{
+    uint64_t hash = cFnvOffset;
+    for(const char* c = typeid(signal).name(); *c; ++c)
+        hash = (hash ^ uint8_t(*c)) * cFnvPrime;
+    return hash;
+}
+
+RenderCache::RenderCache(size_t maxBytes, std::string directory) :
+    maxBytes(maxBytes),
+    directory(std::move(directory))
+{
+    if(!this->directory.empty())
+    {
+        std::error_code error;
+        std::filesystem::create_directories(this->directory, error);
+        if(error)
+            std::print(stderr, "Failed to create cache directory {}: {}\n", this->directory, error.message());
+    }
+}
+
+uint64_t RenderCache::Hash(const SignalSlot& signal)
+{
+    // Shared inputs are hashed once, so fan-out doesn't make the walk exponential
+    std::unordered_map<const Signals::SignalBase*, uint64_t> hashes;
+    std::function<uint64_t(const SignalSlot&)> visit = [&](const SignalSlot& slot) -> uint64_t {
+        if(!slot || !*slot)
+            return cFnvOffset;
+        const Signals::SignalBase* node = slot->get();
+        if(auto found = hashes.find(node); found != hashes.end())
+            return found->second;
+        hashes[node] = cFnvOffset;     // a cycle hashes as an unconnected input instead of recursing forever
+        uint64_t hash = mix(typeHash(*node), node->parameterHash());
+        node->visitInputs([&](const SignalSlot& input) {
+            hash = mix(hash, visit(input));
+        });
+        return hashes[node] = hash;
+    };
+    return visit(signal);
+}
+
+uint64_t RenderCache::Key(const SignalSlot& signal, const Settings& settings)
+{
+    uint64_t key = mix(cFnvOffset, cFormatVersion);
+    for(uint64_t value : {Hash(signal), uint64_t(SAMPLE_RATE), uint64_t(settings.start), settings.frames, uint64_t(settings.lanes),
+        uint64_t(settings.precision), uint64_t(settings.accuracy), uint64_t(settings.periodCache)})
+        key = mix(key, value);
+    return key;
+}
+
+RenderCache::Buffer RenderCache::find(uint64_t key)
+{
+    {
+        std::lock_guard lock(mutex);
+        if(auto found = index.find(key); found != index.end())
+        {
+            entries.splice(entries.begin(), entries, found->second);
+            stats.hits++;
+            return found->second->samples;
+        }
+    }
+    // Outside the lock, other threads keep going while the file is read
+    Buffer samples = directory.empty() ? nullptr : load(key);
+    std::lock_guard lock(mutex);
+    if(!samples)
+    {
+        stats.misses++;
+        return nullptr;
+    }
+    stats.hits++;
+    stats.diskHits++;
+    keep(key, samples);
+    return samples;
+}
+
+void RenderCache::insert(uint64_t key, std::vector<float> samples)
+{
+    if(!directory.empty())
+        save(key, samples);
+    auto shared = std::make_shared<const std::vector<float>>(std::move(samples));
+    std::lock_guard lock(mutex);
+    keep(key, std::move(shared));
+}
+
+void RenderCache::keep(uint64_t key, Buffer samples)
+{
+    const size_t bytes = samples->size() * sizeof(float);
+    if(bytes > maxBytes)
+        return;
+    if(auto found = index.find(key); found != index.end())
+    {
+        stats.bytes -= found->second->samples->size() * sizeof(float);
+        entries.erase(found->second);
+        index.erase(found);
+    }
+    while(!entries.empty() && stats.bytes + bytes > maxBytes)
+    {
+        stats.bytes -= entries.back().samples->size() * sizeof(float);
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+    entries.push_front({key, std::move(samples)});
+    index[key] = entries.begin();
+    stats.bytes += bytes;
+}
+
+void RenderCache::clear()
+{
+    std::lock_guard lock(mutex);
+    entries.clear();
+    index.clear();
+    stats.bytes = 0;
+}
+
+RenderCache::Stats RenderCache::getStats() const
+{
+    std::lock_guard lock(mutex);
+    Stats current = stats;
+    current.entries = entries.size();
+    return current;
+}
+
+std::string RenderCache::filePath(uint64_t key) const
+{
+    return (std::filesystem::path(directory) / std::format("{:016x}.pcm", key)).string();
+}
+
+// File layout: magic, format version, key, sample count, then the samples as 32-bit floats
+RenderCache::Buffer RenderCache::load(uint64_t key) const
+{
+    std::ifstream file(filePath(key), std::ios::binary);
+    if(!file)
+        return nullptr;
+    char magic[4];
+    uint32_t version = 0;
+    uint64_t storedKey = 0, count = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&storedKey), sizeof(storedKey));
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if(!file || std::memcmp(magic, cMagic, sizeof(magic)) != 0 || version != cFormatVersion || storedKey != key)
+        return nullptr;
+    // The count has to match what the file holds, a truncated or corrupt one is a miss and not a huge allocation
+    const std::streamoff header = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff size = file.tellg() - header;
+    file.seekg(header);
+    if(!file || size < 0 || uint64_t(size) % sizeof(float) != 0 || count != uint64_t(size) / sizeof(float))
+        return nullptr;
+    auto samples = std::make_shared<std::vector<float>>(count);
+    file.read(reinterpret_cast<char*>(samples->data()), std::streamsize(count * sizeof(float)));
+    if(!file)
+        return nullptr;
+    return samples;
+}
+
+void RenderCache::save(uint64_t key, const std::vector<float>& samples) const
+{
+    // Written next to the entry and renamed, so readers never see a partial file
+    const std::string path = filePath(key);
+    const std::string partial = std::format("{}.{}.tmp", path, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    bool written = false;
+    {
+        std::ofstream file(partial, std::ios::binary);
+        if(!file)
+        {
+            std::print(stderr, "Failed to create file: {}\n", partial);
+            return;
+        }
+        const uint64_t count = samples.size();
+        file.write(cMagic, sizeof(cMagic));
+        file.write(reinterpret_cast<const char*>(&cFormatVersion), sizeof(cFormatVersion));
+        file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char*>(samples.data()), std::streamsize(count * sizeof(float)));
+        written = file.good();
+    }
+    std::error_code error;
+    if(written)
+        std::filesystem::rename(partial, path, error);
+    else
+        std::print(stderr, "Failed to write file: {}\n", partial);
+    if(!written || error)
+        std::filesystem::remove(partial, error);
+}
+}// namespace DSP
@@ -0,0 +1,91 @@
+#ifndef RENDERCACHE_HPP
+#define RENDERCACHE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "Graph/Graph.hpp"
+#include "Render/Renderer.hpp"
+
+namespace DSP
+{
+/**
+ * @class RenderCache
+ * @brief Rendered buffers by content: the structure of the rendered subgraph and the render settings
+ *
+ * Hash() depends on node types, parameters and which input feeds which port, not on node ids,
+ * editor positions or object addresses, so the same subgraph hashes the same in any patch and
+ * any run. Entries are kept in memory up to maxBytes, least recently used first out. With a
+ * directory every entry is also written there and looked up on a memory miss.
+ * All members are safe to call from several threads.
+ */
+class RenderCache
+{
+public:
+    static constexpr size_t cDefaultBytes = size_t(256) << 20;
+
+    struct Settings
+    {
+        int64_t start = 0;
+        uint64_t frames = 0;
+        uint32_t lanes = 1;
+        Precision precision = Precision::Double;
+        Accuracy accuracy = Accuracy::Exact;
+        bool periodCache = true;
+    };
+
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t diskHits = 0;      // also counted in hits
+        uint64_t misses = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+    using Buffer = std::shared_ptr<const std::vector<float>>;
+
+    RenderCache(size_t maxBytes = cDefaultBytes, std::string directory = {});
+
+    // Structural hash of everything the slot's output depends on
+    static uint64_t Hash(const SignalSlot& signal);
+    // Hash() combined with the render settings and the sample rate
+    static uint64_t Key(const SignalSlot& signal, const Settings& settings);
+
+    Buffer find(uint64_t key);
+    // Buffers above maxBytes are not kept in memory, only on disk
+    void insert(uint64_t key, std::vector<float> samples);
+    void clear();
+
+    Stats getStats() const;
+    size_t getMaxBytes() const { return maxBytes; }
+    const std::string& getDirectory() const { return directory; }
+private:
+    struct Entry
+    {
+        uint64_t key;
+        Buffer samples;
+    };
+
+    std::string filePath(uint64_t key) const;
+    Buffer load(uint64_t key) const;
+    void save(uint64_t key, const std::vector<float>& samples) const;
+    // Caller holds mutex
+    void keep(uint64_t key, Buffer samples);
+
+    size_t maxBytes;
+    std::string directory;
+    mutable std::mutex mutex;
+    std::list<Entry> entries;       // most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+    Stats stats;
+};
+}// namespace DSP
+
+#endif
@@ -0,0 +1,338 @@
+#include "RenderJob.hpp"
+
+#include <cmath>
+#include <chrono>
+#include <format>
+#include <print>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <optional>
+#include <filesystem>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+#include "Graph/GraphIO.hpp"
+#include "Render/Renderer.hpp"
+#include "Render/Profiler.hpp"
+#include "Render/DeadlineMonitor.hpp"
+#include "Render/VoiceEngine.hpp"
+#include "WAVController/WAVController.hpp"
+
+extern const uint32_t SAMPLE_RATE;
+
+namespace DSP
+{
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Renders out in pieces of `piece` values and times each one into monitor, or in one go without a monitor
+template<class Render>
+static void renderTimed(DeadlineMonitor* monitor, size_t piece, std::span<float> out, Render&& render)
+{
+    if(!monitor)
+        return render(out);
+    for(size_t done = 0; done < out.size(); done += piece)
+    {
+        auto blockStart = Clock::now();
+        render(out.subspan(done, std::min(piece, out.size() - done)));
+        monitor->recordBlock(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - blockStart).count());
+    }
+}
+
+static bool isCancelled(const RenderProgress* progress)
+{
+    return progress && progress->cancelled.load(std::memory_order_relaxed);
+}
+
+static void reportProgress(RenderProgress* progress, uint64_t done, uint64_t total)
+{
+    if(!progress)
+        return;
+    progress->total.store(total, std::memory_order_relaxed);
+    progress->done.store(done, std::memory_order_relaxed);
+}
+
+// Going past the budget doesn't fail a render, it is only reported
+static void reportMemory(const Signals::BufferPool& pool, RenderResult& result)
+{
+    auto stats = pool.getStats();
+    result.peakBytes = stats.peak;
+    result.overBudget = stats.overBudget;
+    if(stats.overBudget)
+        std::print(stderr, "Memory budget of {} bytes exceeded {} times, peak {} bytes\n", stats.budget, stats.overBudget, stats.peak);
+}
+
+RenderResult RenderJob::run() const
+{
+    auto start = Clock::now();
+    auto desc = GraphIO::Load(graphPath);
+    if(!desc)
+    {
+        RenderResult result;
+        result.error = std::format("failed to load {}", graphPath);
+        return result;
+    }
+    const double loadSeconds = secondsSince(start);
+    auto result = run(*desc);
+    result.loadSeconds += loadSeconds;
+    return result;
+}
+
+RenderResult RenderJob::run(const GraphDesc& desc) const
+{
+    RenderResult result;
+    if(!(duration > 0.0) || !std::isfinite(duration))
+    {
+        result.error = std::format("invalid duration {}", duration);
+        return result;
+    }
+    auto start = Clock::now();
+    Graph graph(desc);
+    uint32_t variants = Sweep::Apply(graph, sweep, result.error);
+    if(!variants)
+        return result;
+    const bool polyphonic = !notes.empty() || !midiPath.empty();
+    if(polyphonic && !sweep.empty())
+    {
+        result.error = "notes and sweeps both render into the lanes, pick one";
+        return result;
+    }
+    result.loadSeconds = secondsSince(start);
+
+    std::vector<std::ostream*> outs;
+    std::vector<std::ofstream> files;
+    std::vector<std::string> paths;
+    if(outputPath == "-" && sweep.empty())
+    {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        outs.push_back(&std::cout);
+    }
+    else
+    {
+        files.reserve(variants);
+        for(uint32_t i = 0; i < variants; ++i)
+        {
+            std::string path = sweep.empty() ? outputPath : Sweep::VariantPath(outputPath, i);
+            files.emplace_back(path, std::ios::binary);
+            if(!files.back())
+            {
+                result.error = std::format("failed to create {}", path);
+                return result;
+            }
+            outs.push_back(&files.back());
+            paths.push_back(std::move(path));
+        }
+    }
+
+    auto rendered = polyphonic ? renderVoices(desc, *outs.front()) : render(graph, outs);
+    rendered.loadSeconds = result.loadSeconds;
+    // A cancelled render leaves no truncated files behind
+    if(isCancelled(progress))
+    {
+        files.clear();
+        std::error_code error;
+        for(auto& path : paths)
+            std::filesystem::remove(path, error);
+    }
+    return rendered;
+}
+
+RenderResult RenderJob::render(Graph& graph, std::span<std::ostream* const> outs) const
+{
+    RenderResult result;
+    auto& outputs = graph.getOutputs();
+    if(outputs.empty())
+    {
+        result.error = "graph has no Output node";
+        return result;
+    }
+    uint32_t nodeId = node ? node : outputs.front();
+    if(std::find(outputs.begin(), outputs.end(), nodeId) == outputs.end())
+    {
+        result.error = std::format("node {} is not an Output node", nodeId);
+        return result;
+    }
+    const uint32_t lanes = static_cast<uint32_t>(outs.size());
+    Renderer renderer(graph.getSignal(nodeId), 0, lanes, precision, accuracy);
+    if(!renderer.isValid())
+    {
+        result.error = std::format("Output node {} is not connected or has an unconnected input upstream", nodeId);
+        return result;
+    }
+    renderer.setPeriodCache(periodCache);
+    graph.getPool()->setBudget(memoryBudget);
+
+    auto start = Clock::now();
+    const uint64_t total = static_cast<uint64_t>(duration * SAMPLE_RATE);
+    if(!raw)
+    {
+        for(auto* out : outs)
+            WAVController::WriteWAVHeader(*out, total);
+    }
+
+    auto good = [&outs] { return std::all_of(outs.begin(), outs.end(), [](std::ostream* out) { return out->good(); }); };
+    DeadlineMonitor monitor(cMonitorBlock, SAMPLE_RATE);
+    // Profiles and deadline logs measure a render, so those always run one
+    const bool useCache = cache && profilePath.empty() && deadlineLog.empty();
+    const uint64_t key = useCache ? RenderCache::Key(renderer.getSignal(), {0, total, lanes, precision, accuracy, periodCache}) : 0;
+    RenderCache::Buffer hit = useCache ? cache->find(key) : nullptr;
+    if(hit && hit->size() != total * lanes)
+        hit = nullptr;
+    std::vector<float> recorded;
+    // The recording is held in memory until the render ends, so it has to fit the cache's memory even when it goes to disk
+    const bool record = useCache && !hit && total * lanes * sizeof(float) <= cache->getMaxBytes();
+    size_t read = 0;
+    auto renderChunk = [&](std::span<float> out) {
+        if(hit)
+        {
+            std::copy_n(hit->data() + read, out.size(), out.data());
+            read += out.size();
+            return;
+        }
+        renderTimed(deadlineLog.empty() ? nullptr : &monitor, cMonitorBlock * lanes, out, [&renderer](std::span<float> piece) {
+            renderer.render(piece);
+        });
+        if(record)
+            recorded.insert(recorded.end(), out.begin(), out.end());
+    };
+    std::vector<float> interleaved(cChunkSize * lanes);
+    std::vector<float> chunk(cChunkSize);
+    for(uint64_t done = 0; done < total && good() && !isCancelled(progress); done += chunk.size())
+    {
+        reportProgress(progress, done, total);
+        const size_t frames = std::min<uint64_t>(cChunkSize, total - done);
+        chunk.resize(frames);
+        if(lanes == 1)
+        {
+            renderChunk(chunk);
+            WAVController::WriteSamples(*outs[0], chunk);
+            continue;
+        }
+        renderChunk(std::span(interleaved).first(frames * lanes));
+        for(uint32_t lane = 0; lane < lanes; ++lane)
+        {
+            for(size_t i = 0; i < frames; ++i)
+                chunk[i] = interleaved[i * lanes + lane];
+            WAVController::WriteSamples(*outs[lane], chunk);
+        }
+    }
+    for(auto* out : outs)
+        out->flush();
+    result.renderSeconds = secondsSince(start);
+    if(isCancelled(progress))
+    {
+        result.error = "cancelled";
+        return result;
+    }
+    if(!good())
+    {
+        result.error = "failed to write output";
+        return result;
+    }
+    reportProgress(progress, total, total);
+    if(record)
+        cache->insert(key, std::move(recorded));
+    result.cached = hit != nullptr;
+    reportMemory(*graph.getPool(), result);
+    if(!profilePath.empty() && !Profiler::Save(profilePath, Profiler::Collect(graph)))
+    {
+        result.error = std::format("failed to write {}", profilePath);
+        return result;
+    }
+    if(!deadlineLog.empty() && !DeadlineMonitor::Save(deadlineLog, monitor.snapshot()))
+    {
+        result.error = std::format("failed to write {}", deadlineLog);
+        return result;
+    }
+    result.samples = total;
+    result.ok = true;
+    return result;
+}
+
+RenderResult RenderJob::renderVoices(const GraphDesc& desc, std::ostream& out) const
+{
+    RenderResult result;
+    VoiceEngine engine(desc, node, voices, precision, accuracy);
+    if(!engine.isValid())
+    {
+        result.error = engine.getError();
+        return result;
+    }
+    engine.getGraph().getPool()->setBudget(memoryBudget);
+    for(uint8_t note : notes)
+        engine.noteOn(note);
+    uint64_t total = static_cast<uint64_t>(duration * SAMPLE_RATE);
+    std::optional<Sequencer> sequencer;
+    if(!midiPath.empty())
+    {
+        auto events = MidiFile::Load(midiPath);
+        if(!events)
+        {
+            result.error = std::format("failed to load {}", midiPath);
+            return result;
+        }
+        sequencer.emplace(engine, *events, controllers);
+        if(!sequencer->isValid())
+        {
+            result.error = sequencer->getError();
+            return result;
+        }
+        total = static_cast<uint64_t>(sequencer->getLength()) + static_cast<uint64_t>(cMidiTail * SAMPLE_RATE);
+    }
+
+    auto start = Clock::now();
+    if(!raw)
+        WAVController::WriteWAVHeader(out, total);
+    DeadlineMonitor monitor(cMonitorBlock, SAMPLE_RATE);
+    std::vector<float> chunk(cChunkSize);
+    for(uint64_t done = 0; done < total && out.good() && !isCancelled(progress); done += chunk.size())
+    {
+        reportProgress(progress, done, total);
+        chunk.resize(std::min<uint64_t>(cChunkSize, total - done));
+        renderTimed(deadlineLog.empty() ? nullptr : &monitor, cMonitorBlock, chunk, [&engine, &sequencer](std::span<float> piece) {
+            if(sequencer)
+                sequencer->render(piece);
+            else
+                engine.render(piece);
+        });
+        WAVController::WriteSamples(out, chunk);
+    }
+    out.flush();
+    result.renderSeconds = secondsSince(start);
+    if(isCancelled(progress))
+    {
+        result.error = "cancelled";
+        return result;
+    }
+    if(!out.good())
+    {
+        result.error = "failed to write output";
+        return result;
+    }
+    reportProgress(progress, total, total);
+    reportMemory(*engine.getGraph().getPool(), result);
+    if(!profilePath.empty() && !Profiler::Save(profilePath, Profiler::Collect(engine.getGraph())))
+    {
+        result.error = std::format("failed to write {}", profilePath);
+        return result;
+    }
+    if(!deadlineLog.empty() && !DeadlineMonitor::Save(deadlineLog, monitor.snapshot()))
+    {
+        result.error = std::format("failed to write {}", deadlineLog);
+        return result;
+    }
+    result.samples = total;
+    result.ok = true;
+    return result;
+}
+}// namespace DSP
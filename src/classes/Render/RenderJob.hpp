@@ -0,0 +1,85 @@
+#ifndef RENDERJOB_HPP
+#define RENDERJOB_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <span>
+#include <ostream>
+#include <atomic>
+
+#include "Graph/Graph.hpp"
+#include "Render/Sweep.hpp"
+#include "Render/Renderer.hpp"
+#include "Render/Sequencer.hpp"
+#include "Render/RenderCache.hpp"
+
+namespace DSP
+{
+struct RenderResult
+{
+    bool ok = false;
+    std::string error;
+    uint64_t samples = 0;
+    double loadSeconds = 0.0;
+    double renderSeconds = 0.0;
+    bool cached = false;
+    uint64_t peakBytes = 0;         // high water mark of the graph's BufferPool
+    uint64_t overBudget = 0;        // buffers served past memoryBudget
+};
+
+/**
+ * @brief Progress of a running job, written by the job and read or cancelled from any thread
+ */
+struct RenderProgress
+{
+    std::atomic<uint64_t> done = 0;     // sample frames
+    std::atomic<uint64_t> total = 0;
+    std::atomic<bool> cancelled = false;
+
+    double fraction() const
+    {
+        const uint64_t frames = total.load(std::memory_order_relaxed);
+        return frames ? double(done.load(std::memory_order_relaxed)) / double(frames) : 0.0;
+    }
+};
+
+/**
+ * @brief One graph file rendered to one WAV or raw PCM output, streamed in chunks
+ */
+struct RenderJob
+{
+    static constexpr size_t cChunkSize = 4096;
+    static constexpr size_t cMonitorBlock = 256;    // audio callback sized blocks timed for deadlineLog
+    static constexpr double cMidiTail = 1.0;        // seconds rendered after the last MIDI event, for releases
+
+    std::string graphPath;
+    std::string outputPath = "-";   // '-' is stdout
+    double duration = 0.0;          // seconds
+    uint32_t node = 0;              // Output node id, 0 picks the first one
+    bool raw = false;
+    Precision precision = Precision::Double;
+    Accuracy accuracy = Accuracy::Exact;
+    bool periodCache = true;        // periodic subgraphs loop one cached period, see SignalBase::periodicity()
+    std::vector<Sweep::Parameter> sweep; // one output per variant, named by Sweep::VariantPath
+    std::string profilePath;        // per-node counters written here after the render, see Profiler
+    std::string deadlineLog;        // when set, every cMonitorBlock frames are timed against real time, see DeadlineMonitor
+    std::vector<uint8_t> notes;     // MIDI notes held for the whole render through a VoiceEngine, the graph is the voice
+    uint32_t voices = 8;
+    std::string midiPath;           // Standard MIDI File played through the VoiceEngine, replaces duration
+    std::vector<Sequencer::Controller> controllers;
+    RenderCache* cache = nullptr;   // graph renders are served from and added to it, unless profiled or timed
+    RenderProgress* progress = nullptr;     // updated every chunk; cancelling ends the job with an error
+    size_t memoryBudget = 0;        // bytes of the graph's BufferPool, 0 is unlimited
+
+    RenderResult run() const;
+    // Renders desc instead of loading graphPath
+    RenderResult run(const GraphDesc& desc) const;
+    // Renders one lane per stream
+    RenderResult render(Graph& graph, std::span<std::ostream* const> outs) const;
+    // Renders the notes or the MIDI file polyphonically, mixed to one stream
+    RenderResult renderVoices(const GraphDesc& desc, std::ostream& out) const;
+};
+}// namespace DSP
+
+#endif
@@ -0,0 +1,57 @@
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+
+namespace DSP
+{
+RenderQueue::RenderQueue(size_t threadCount) :
+    pool(threadCount)
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+    std::lock_guard lock(mutex);
+    for(auto& weak : tasks)
+    {
+        if(auto task = weak.lock())
+            task->cancel();
+    }
+}
+
+std::shared_ptr<RenderTask> RenderQueue::submit(RenderJob job, std::optional<GraphDesc> desc)
+{
+    auto task = std::make_shared<RenderTask>();
+    job.progress = &task->progress;
+    // The work keeps the task alive, progress is written into it until the job returns
+    auto work = std::make_shared<std::packaged_task<RenderResult()>>([task, job = std::move(job), desc = std::move(desc)] {
+        if(task->isCancelled())
+        {
+            RenderResult result;
+            result.error = "cancelled";
+            return result;
+        }
+        return desc ? job.run(*desc) : job.run();
+    });
+    task->result = work->get_future().share();
+    {
+        std::lock_guard lock(mutex);
+        std::erase_if(tasks, [](const std::weak_ptr<RenderTask>& weak) {
+            auto task = weak.lock();
+            return !task || task->isDone();
+        });
+        tasks.push_back(task);
+    }
+    pool.submit([work] { (*work)(); });
+    return task;
+}
+
+size_t RenderQueue::getRunning() const
+{
+    std::lock_guard lock(mutex);
+    return std::count_if(tasks.begin(), tasks.end(), [](const std::weak_ptr<RenderTask>& weak) {
+        auto task = weak.lock();
+        return task && !task->isDone();
+    });
+}
+}// namespace DSP
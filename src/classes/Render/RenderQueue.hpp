@@ -0,0 +1,59 @@
+#ifndef RENDERQUEUE_HPP
+#define RENDERQUEUE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <algorithm>
+#include <mutex>
+#include <future>
+#include <optional>
+#include <vector>
+
+#include "Render/RenderJob.hpp"
+#include "Render/ThreadPool.hpp"
+
+namespace DSP
+{
+/**
+ * @class RenderTask
+ * @brief Handle of a job running on a RenderQueue: its progress, cancellation and result
+ *
+ * Every member may be called from any thread, none of them blocks except getResult().get().
+ */
+class RenderTask
+{
+public:
+    double getProgress() const { return progress.fraction(); }
+    void cancel() { progress.cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return progress.cancelled.load(std::memory_order_relaxed); }
+    bool isDone() const { return result.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+    const std::shared_future<RenderResult>& getResult() const { return result; }
+private:
+    friend class RenderQueue;
+    RenderProgress progress;
+    std::shared_future<RenderResult> result;
+};
+
+/**
+ * @class RenderQueue
+ * @brief Runs render jobs in the background, several at once, so the caller never waits on a render
+ *
+ * Jobs given a GraphDesc render their own Graph built from it, never the caller's signals.
+ * Destroying the queue cancels whatever is still running and waits for it to stop.
+ */
+class RenderQueue
+{
+public:
+    RenderQueue(size_t threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    ~RenderQueue();
+
+    std::shared_ptr<RenderTask> submit(RenderJob job, std::optional<GraphDesc> desc = std::nullopt);
+    size_t getRunning() const;
+private:
+    mutable std::mutex mutex;
+    std::vector<std::weak_ptr<RenderTask>> tasks;
+    ThreadPool pool;
+};
+}// namespace DSP
+
+#endif
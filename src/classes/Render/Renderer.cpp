@@ -0,0 +1,110 @@
+#include "Renderer.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+#include "Signals/Signals.hpp"
+
+namespace DSP
+{
+// Keeps lanes * blockSize near this many values so wide sweeps still fit in cache
+static constexpr uint32_t cBlockValues = 4096;
+// Block indices are never reused, so a node's memoized output can't outlive an edit or a seek
+static std::atomic<uint64_t> nextBlockIndex = 1;
+
+Renderer::Renderer(const SignalSlot& signal, int64_t start, uint32_t lanes, Precision precision, Accuracy accuracy) :
+    signal(signal),
+    position(start),
+    lanes(std::max<uint32_t>(lanes, 1)),
+    precision(precision),
+    accuracy(accuracy),
+    blockSize(std::clamp<uint32_t>(cBlockValues / this->lanes, 16, Signals::Block::cMaxSize)),
+    checkpoints(signal)
+{
+    if(signal && *signal)
+    {
+        Signals::SignalBase::StatefulMarks marks;
+        Signals::SignalBase::MarkStateful(**signal, marks);
+    }
+    if(start != 0 && checkpoints.isStateful())
+    {
+        position = 0;
+        seek(start);
+    }
+}
+
+void Renderer::seek(int64_t sample)
+{
+    if(!checkpoints.isStateful())
+    {
+        position = sample;
+        return;
+    }
+    // Keep going from the current position when it is already past the best checkpoint
+    if(sample < position || position < checkpoints.latest(sample))
+        position = checkpoints.restore(sample);
+    while(position < sample)
+        advance(static_cast<uint32_t>(std::min<int64_t>(blockSize, sample - position)));
+}
+
+template<class T, class Out>
+void Renderer::copyBlock(const T* source, bool varying, uint32_t size, Out* dst) const
+{
+    if(varying)
+        std::copy_n(source, size_t(size) * lanes, dst);
+    else
+    {
+        for(size_t i = 0; i < size; ++i)
+            std::fill_n(dst + i * lanes, lanes, static_cast<Out>(source[i]));
+    }
+}
+
+bool Renderer::advance(uint32_t size)
+{
+    Signals::Block current;
+    current.start = position;
+    current.size = size;
+    current.lanes = lanes;
+    current.index = nextBlockIndex.fetch_add(1, std::memory_order_relaxed);
+    current.accuracy = accuracy;
+    current.loopPeriods = periodCache;
+
+    // Through evaluate(), so a periodic root loops its period as well
+    bool varying;
+    if(precision == Precision::Float)
+        varying = (floatOutput = (*signal)->evaluate<float>(current)).varying;
+    else
+        varying = (output = (*signal)->evaluate<double>(current)).varying;
+    block = current;
+    position += size;
+    checkpoints.record(position);
+    return varying;
+}
+
+template<class Out>
+void Renderer::renderTo(std::span<Out> out)
+{
+    const size_t frames = out.size() / lanes;
+    for(size_t done = 0; done < frames;)
+    {
+        const uint32_t size = static_cast<uint32_t>(std::min<size_t>(blockSize, frames - done));
+        bool varying = advance(size);
+        Out* dst = out.data() + done * lanes;
+        if(precision == Precision::Float)
+            copyBlock(floatOutput.data, varying, size, dst);
+        else
+            copyBlock(output.data, varying, size, dst);
+        done += size;
+    }
+}
+
+void Renderer::render(std::span<float> out)
+{
+    renderTo(out);
+}
+
+void Renderer::render(std::span<double> out)
+{
+    renderTo(out);
+}
+}// namespace DSP
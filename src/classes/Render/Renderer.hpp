@@ -0,0 +1,77 @@
+#ifndef RENDERER_HPP
+#define RENDERER_HPP
+
+#include <cstdint>
+#include <span>
+
+#include "Graph/Graph.hpp"
+#include "Math/FastMath.hpp"
+#include "Signals/Block.hpp"
+#include "Checkpoints.hpp"
+
+namespace DSP
+{
+// Sample type of the block engine; phase and time are formed in double either way
+enum class Precision
+{
+    Double,
+    Float
+};
+
+/**
+ * @class Renderer
+ * @brief Pulls consecutive blocks out of a signal slot
+ *
+ * With more than one lane the output is interleaved, one frame of `lanes` samples per sample index.
+ * Graphs with stateful signals keep checkpoints while rendering; seek() restores the latest one
+ * before the target and pre-rolls the rest.
+ */
+class Renderer
+{
+public:
+    Renderer(const SignalSlot& signal, int64_t start = 0, uint32_t lanes = 1, Precision precision = Precision::Double, Accuracy accuracy = Accuracy::Exact);
+
+    // The root and everything upstream of it, see SignalBase::IsValidGraph()
+    bool isValid() const { return signal && *signal && Signals::SignalBase::IsValidGraph(**signal); }
+    const SignalSlot& getSignal() const { return signal; }
+    void render(std::span<float> out);
+    // Keeps the double engine's output unrounded, for comparisons against get()
+    void render(std::span<double> out);
+    void seek(int64_t sample);
+    int64_t getPosition() const { return position; }
+    uint32_t getLanes() const { return lanes; }
+    // Frames per block; render() of at most this many frames renders exactly one block
+    uint32_t getBlockSize() const { return blockSize; }
+    // The block the last render() ended with, the key of the memos it left in the graph
+    const Signals::Block& getBlock() const { return block; }
+    Precision getPrecision() const { return precision; }
+    Accuracy getAccuracy() const { return accuracy; }
+    const Checkpoints& getCheckpoints() const { return checkpoints; }
+    // Periodic subgraphs loop one cached period; off computes every sample
+    void setPeriodCache(bool enabled) { periodCache = enabled; }
+    bool getPeriodCache() const { return periodCache; }
+private:
+    // Renders the next block into `output` or `floatOutput` and returns whether it varies per lane
+    bool advance(uint32_t size);
+    // Broadcasts uniform results to every lane
+    template<class T, class Out>
+    void copyBlock(const T* source, bool varying, uint32_t size, Out* dst) const;
+    template<class Out>
+    void renderTo(std::span<Out> out);
+
+    SignalSlot signal;
+    int64_t position = 0;
+    uint32_t lanes = 1;
+    Precision precision = Precision::Double;
+    Accuracy accuracy = Accuracy::Exact;
+    uint32_t blockSize = 0;
+    bool periodCache = true;
+    // Views of the root signal's own output, valid until the next advance()
+    Signals::BasicLanes<double> output;
+    Signals::BasicLanes<float> floatOutput;
+    Signals::Block block;
+    Checkpoints checkpoints;
+};
+}// namespace DSP
+
+#endif
@@ -0,0 +1,101 @@
+#include "Sequencer.hpp"
+
+#include <cmath>
+#include <charconv>
+#include <format>
+#include <algorithm>
+
+#include "Signals/Signals.hpp"
+
+extern const uint32_t SAMPLE_RATE;
+
+namespace DSP
+{
+template<class T>
+static bool parseNumber(std::string_view str, T& value)
+{
+    auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc() && end == str.data() + str.size();
+}
+
+std::optional<Sequencer::Controller> Sequencer::ParseController(std::string_view spec)
+{
+    Controller controller;
+    size_t eq = spec.find('=');
+    if(eq == std::string_view::npos || !parseNumber(spec.substr(0, eq), controller.number) || controller.number > 127)
+        return std::nullopt;
+    std::string_view target = spec.substr(eq + 1);
+    size_t colon = target.find(':');
+    if(!parseNumber(target.substr(0, colon), controller.node))
+        return std::nullopt;
+    if(colon == std::string_view::npos)
+        return controller;
+    std::string_view range = target.substr(colon + 1);
+    size_t second = range.find(':');
+    if(second == std::string_view::npos ||
+        !parseNumber(range.substr(0, second), controller.min) ||
+        !parseNumber(range.substr(second + 1), controller.max))
+        return std::nullopt;
+    return controller;
+}
+
+Sequencer::Sequencer(VoiceEngine& engine, const std::vector<MidiFile::Event>& events, std::vector<Controller> controllers) :
+    engine(engine),
+    controllers(std::move(controllers))
+{
+    for(auto& controller : this->controllers)
+    {
+        auto* node = engine.getGraph().getDesc().findNode(controller.node);
+        if(!node || node->type != Constant)
+        {
+            error = std::format("controller {} is mapped to node {}, which is not a Constant", controller.number, controller.node);
+            return;
+        }
+    }
+    this->events.reserve(events.size());
+    for(auto& event : events)
+        this->events.push_back({std::llround(event.seconds * SAMPLE_RATE), event});
+    // Events are rendered from the engine's position on
+    next = std::lower_bound(this->events.begin(), this->events.end(), engine.getPosition(),
+        [](const TimedEvent& event, int64_t sample) { return event.sample < sample; }) - this->events.begin();
+}
+
+void Sequencer::apply(const MidiFile::Event& event)
+{
+    switch(event.type)
+    {
+        case MidiFile::EventType::NoteOn:
+            engine.noteOn(event.number, event.value / 127.0);
+            break;
+        case MidiFile::EventType::NoteOff:
+            engine.noteOff(event.number);
+            break;
+        case MidiFile::EventType::Controller:
+            for(auto& controller : controllers)
+            {
+                if(controller.number != event.number)
+                    continue;
+                auto& slot = engine.getGraph().getSignal(controller.node);
+                if(auto* constant = dynamic_cast<Signals::Constant*>(slot->get()))
+                    constant->set(controller.min + (controller.max - controller.min) * event.value / 127.0);
+            }
+            break;
+    }
+}
+
+void Sequencer::render(std::span<float> out)
+{
+    int64_t position = engine.getPosition();
+    while(!out.empty())
+    {
+        while(next < events.size() && events[next].sample <= position)
+            apply(events[next++].event);
+        size_t frames = out.size();
+        if(next < events.size())
+            frames = std::min<size_t>(frames, events[next].sample - position);
+        engine.render(out.first(frames));
+        out = out.subspan(frames);
+        position += static_cast<int64_t>(frames);
+    }
+}
+}// namespace DSP
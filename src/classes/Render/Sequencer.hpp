@@ -0,0 +1,62 @@
+#ifndef SEQUENCER_HPP
+#define SEQUENCER_HPP
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+
+#include "Midi/MidiFile.hpp"
+#include "Render/VoiceEngine.hpp"
+
+namespace DSP
+{
+/**
+ * @class Sequencer
+ * @brief Plays timed MIDI events into a VoiceEngine, sample-accurately
+ *
+ * Every render() is cut exactly at the events falling inside it: the engine renders up to
+ * the event's sample in whole blocks, the event is applied, rendering continues. Notes become
+ * voice triggers, controllers set the value of mapped Constant nodes of the voice graph.
+ */
+class Sequencer
+{
+public:
+    // Controller values 0..127 mapped linearly onto [min, max] of a Constant node
+    struct Controller
+    {
+        uint8_t number = 0;
+        uint32_t node = 0;
+        double min = 0.0;
+        double max = 1.0;
+    };
+    // "<controller>=<node>" or "<controller>=<node>:<min>:<max>"
+    static std::optional<Controller> ParseController(std::string_view spec);
+
+    Sequencer(VoiceEngine& engine, const std::vector<MidiFile::Event>& events, std::vector<Controller> controllers = {});
+
+    bool isValid() const { return error.empty(); }
+    const std::string& getError() const { return error; }
+    // Sample of the last event
+    int64_t getLength() const { return events.empty() ? 0 : events.back().sample; }
+
+    void render(std::span<float> out);
+private:
+    struct TimedEvent
+    {
+        int64_t sample;
+        MidiFile::Event event;
+    };
+    void apply(const MidiFile::Event& event);
+
+    VoiceEngine& engine;
+    std::vector<TimedEvent> events;
+    std::vector<Controller> controllers;
+    size_t next = 0;
+    std::string error;
+};
+}// namespace DSP
+
+#endif
@@ -0,0 +1,93 @@
+#include "Sweep.hpp"
+
+#include <charconv>
+#include <format>
+
+#include "Signals/Signals.hpp"
+
+namespace DSP
+{
+template<class T>
+static bool parseNumber(std::string_view str, T& value)
+{
+    auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc() && end == str.data() + str.size();
+}
+
+std::optional<Sweep::Parameter> Sweep::Parse(std::string_view spec)
+{
+    Parameter parameter;
+    size_t eq = spec.find('=');
+    if(eq == std::string_view::npos || !parseNumber(spec.substr(0, eq), parameter.node))
+        return std::nullopt;
+    std::string_view values = spec.substr(eq + 1);
+
+    size_t colon = values.find(':');
+    if(colon != std::string_view::npos)
+    {
+        size_t second = values.find(':', colon + 1);
+        double from, to;
+        size_t count;
+        if(second == std::string_view::npos ||
+            !parseNumber(values.substr(0, colon), from) ||
+            !parseNumber(values.substr(colon + 1, second - colon - 1), to) ||
+            !parseNumber(values.substr(second + 1), count) || count == 0)
+            return std::nullopt;
+        for(size_t i = 0; i < count; ++i)
+            parameter.values.push_back(count == 1 ? from : from + (to - from) * i / (count - 1));
+        return parameter;
+    }
+
+    while(!values.empty())
+    {
+        size_t comma = values.find(',');
+        double value;
+        if(!parseNumber(values.substr(0, comma), value))
+            return std::nullopt;
+        parameter.values.push_back(value);
+        values = comma == std::string_view::npos ? std::string_view() : values.substr(comma + 1);
+    }
+    if(parameter.values.empty())
+        return std::nullopt;
+    return parameter;
+}
+
+uint32_t Sweep::Apply(Graph& graph, const std::vector<Parameter>& parameters, std::string& error)
+{
+    if(parameters.empty())
+        return 1;
+    const size_t lanes = parameters.front().values.size();
+    for(auto& parameter : parameters)
+    {
+        auto* node = graph.getDesc().findNode(parameter.node);
+        if(!node || node->type != Constant)
+        {
+            error = std::format("node {} is not a Constant", parameter.node);
+            return 0;
+        }
+        if(parameter.values.size() != lanes)
+        {
+            error = std::format("sweep of node {} has {} values, expected {}", parameter.node, parameter.values.size(), lanes);
+            return 0;
+        }
+    }
+    // Slots are shared with every consumer, so swapping the pointee rewires the whole graph
+    for(auto& parameter : parameters)
+        *graph.getSignal(parameter.node) = std::make_shared<Signals::LaneConstant>(parameter.values);
+    graph.adoptSignals();
+    return static_cast<uint32_t>(lanes);
+}
+
+std::string Sweep::VariantPath(const std::string& path, size_t index)
+{
+    std::string result = path;
+    size_t pattern = result.find("{}");
+    if(pattern != std::string::npos)
+        return result.replace(pattern, 2, std::to_string(index));
+    size_t dot = result.find_last_of('.');
+    size_t slash = result.find_last_of("/\\");
+    if(dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        dot = result.size();
+    return result.insert(dot, "_" + std::to_string(index));
+}
+}// namespace DSP
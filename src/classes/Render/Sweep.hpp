@@ -0,0 +1,39 @@
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+
+#include "Graph/Graph.hpp"
+
+namespace DSP
+{
+/**
+ * @class Sweep
+ * @brief Renders several values of chosen Constant nodes in one pass, one variant per lane
+ *
+ * Only the part of the graph downstream of a swept Constant is evaluated per lane;
+ * everything else is computed once per block and shared by all variants.
+ */
+class Sweep
+{
+public:
+    struct Parameter
+    {
+        uint32_t node = 0;
+        std::vector<double> values;
+    };
+
+    // "<node>=<v1>,<v2>,..." or "<node>=<from>:<to>:<count>"
+    static std::optional<Parameter> Parse(std::string_view spec);
+    // Swaps the swept Constant nodes for per-lane values; returns the variant count, 0 on error
+    static uint32_t Apply(Graph& graph, const std::vector<Parameter>& parameters, std::string& error);
+    // Replaces "{}" in path with the variant index, or appends _<index> before the extension
+    static std::string VariantPath(const std::string& path, size_t index);
+};
+}// namespace DSP
+
+#endif
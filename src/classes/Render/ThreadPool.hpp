@@ -0,0 +1,43 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <cstddef>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+
+namespace DSP
+{
+/**
+ * @class ThreadPool
+ * @brief Fixed set of worker threads pulling tasks from one shared queue
+ */
+class ThreadPool
+{
+public:
+    ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    void submit(std::function<void()> task);
+    // Blocks until every submitted task, including ones submitted by tasks, has finished
+    void wait();
+    size_t getSize() const { return workers.size(); }
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable allDone;
+    size_t pending = 0;
+    bool stopping = false;
+};
+}// namespace DSP
+
+#endif
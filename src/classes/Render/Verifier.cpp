@@ -0,0 +1,264 @@
+#include "Verifier.hpp"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <charconv>
+#include <print>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <unordered_set>
+
+#include "Graph/GraphIO.hpp"
+#include "Graph/Json.hpp"
+#include "Signals/Signals.hpp"
+
+namespace DSP
+{
+// Frames compared per step in full mode
+static constexpr size_t cChunkSize = 4096;
+
+static bool parseNumber(std::string_view str, double& value)
+{
+    auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc() && end == str.data() + str.size();
+}
+
+double Verifier::Settings::tolerance() const
+{
+    const double tier = tolerances[static_cast<size_t>(accuracy)];
+    return precision == Precision::Float ? std::max(tier, cFloatTolerance) : tier;
+}
+
+std::optional<Verifier::Tolerances> Verifier::ParseTolerances(std::string_view spec, Tolerances base)
+{
+    constexpr std::string_view cNames[] = {"exact", "high", "fast"};
+    while(!spec.empty())
+    {
+        const size_t comma = spec.find(',');
+        const std::string_view item = spec.substr(0, comma);
+        const size_t eq = item.find('=');
+        const auto name = std::find(std::begin(cNames), std::end(cNames), item.substr(0, eq));
+        double value;
+        if(eq == std::string_view::npos || name == std::end(cNames) || !parseNumber(item.substr(eq + 1), value) || !(value >= 0.0))
+        {
+            std::print(stderr, "Invalid tolerance '{}', expected exact=<t>, high=<t> or fast=<t>\n", item);
+            return std::nullopt;
+        }
+        base[name - std::begin(cNames)] = value;
+        spec = comma == std::string_view::npos ? std::string_view() : spec.substr(comma + 1);
+    }
+    return base;
+}
+
+std::vector<VerifyEntry> Verifier::Run(const GraphDesc& desc, const Settings& settings)
+{
+    // Stateful signals restart whenever a render doesn't continue their last one, so every node
+    // starts from the same state in one shared pair of graphs
+    Graph blocks(desc), reference(desc);
+    std::vector<VerifyEntry> entries;
+    for(auto& node : desc.nodes)
+    {
+        if(Graph::isSink(node.type) || !blocks.hasNode(node.id))
+            continue;
+        auto& slot = blocks.getSignal(node.id);
+        auto& expected = reference.getSignal(node.id);
+        if(slot && *slot && expected && *expected && Signals::SignalBase::IsValidGraph(**slot))
+            entries.push_back(Compare(node, slot, expected, settings));
+    }
+    for(uint32_t output : blocks.getOutputs())
+    {
+        auto context = CompareInContext(desc, output, settings);
+        entries.insert(entries.end(), context.begin(), context.end());
+    }
+    return entries;
+}
+
+// Adds one compared sample to entry, squares sums the squared errors
+static void accumulate(VerifyEntry& entry, double& squares, int64_t sample, double actual, double value)
+{
+    double error = actual == value ? 0.0 : std::abs(actual - value);
+    // NaN on one side only is as wrong as it gets
+    if(std::isnan(error))
+        error = std::isnan(actual) && std::isnan(value) ? 0.0 : std::numeric_limits<double>::infinity();
+    if(error > entry.maxError)
+    {
+        entry.maxError = error;
+        entry.maxErrorAt = sample;
+    }
+    if(entry.firstDivergent < 0 && error > entry.tolerance * std::max(1.0, std::abs(value)))
+        entry.firstDivergent = sample;
+    squares += error * error;
+    ++entry.samples;
+}
+
+VerifyEntry Verifier::Compare(const GraphDesc::Node& node, const SignalSlot& slot, const SignalSlot& expected, const Settings& settings)
+{
+    VerifyEntry entry;
+    entry.id = node.id;
+    entry.type = GraphIO::TypeName(node.type);
+    entry.tolerance = settings.tolerance();
+
+    Renderer renderer(slot, 0, 1, settings.precision, settings.accuracy);
+    renderer.setPeriodCache(settings.periodCache);
+    const size_t window = settings.every ? Signals::Block::cMaxSize : cChunkSize;
+    const uint64_t step = settings.every ? uint64_t(settings.every) * Signals::Block::cMaxSize : cChunkSize;
+    std::vector<double> actual(window);
+    double squares = 0.0;
+    for(uint64_t start = 0; start < settings.frames; start += step)
+    {
+        const size_t size = static_cast<size_t>(std::min<uint64_t>(window, settings.frames - start));
+        renderer.seek(static_cast<int64_t>(start));
+        renderer.render(std::span(actual.data(), size));
+        for(size_t i = 0; i < size; ++i)
+        {
+            const int64_t sample = static_cast<int64_t>(start + i);
+            accumulate(entry, squares, sample, actual[i], (*expected)->get(static_cast<double>(sample)));
+        }
+    }
+    entry.rmsError = entry.samples ? std::sqrt(squares / double(entry.samples)) : 0.0;
+    return entry;
+}
+
+std::vector<VerifyEntry> Verifier::CompareInContext(const GraphDesc& desc, uint32_t output, const Settings& settings)
+{
+    std::vector<VerifyEntry> entries;
+    Graph graph(desc);
+    const auto& root = graph.getSignal(output);
+    if(!root || !*root || !Signals::SignalBase::IsValidGraph(**root))
+        return entries;
+
+    std::unordered_set<const Signals::SignalBase*> upstream{root->get()};
+    std::vector<const Signals::SignalBase*> pending{root->get()};
+    while(!pending.empty())
+    {
+        const Signals::SignalBase* signal = pending.back();
+        pending.pop_back();
+        signal->visitInputs([&upstream, &pending](const SignalSlot& input) {
+            if(input && *input && upstream.insert(input->get()).second)
+                pending.push_back(input->get());
+        });
+    }
+
+    // Every node's reference runs in a graph of its own, so no two of them step the same state
+    struct Shadow
+    {
+        const Signals::SignalBase* signal;
+        std::unique_ptr<Graph> graph;
+        SignalSlot expected;
+        VerifyEntry entry;
+        double squares = 0.0;
+    };
+    std::list<Shadow> shadows;
+    for(auto& node : desc.nodes)
+    {
+        if(Graph::isSink(node.type) || !graph.hasNode(node.id))
+            continue;
+        const auto& slot = graph.getSignal(node.id);
+        if(!slot || !*slot || !upstream.contains(slot->get()))
+            continue;
+        auto& shadow = shadows.emplace_back(slot->get(), std::make_unique<Graph>(desc));
+        shadow.expected = shadow.graph->getSignal(node.id);
+        shadow.entry.id = node.id;
+        shadow.entry.root = output;
+        shadow.entry.type = GraphIO::TypeName(node.type);
+        shadow.entry.tolerance = settings.tolerance();
+    }
+
+    Renderer renderer(root, 0, 1, settings.precision, settings.accuracy);
+    renderer.setPeriodCache(settings.periodCache);
+    const size_t block = renderer.getBlockSize();
+    const size_t window = settings.every ? Signals::Block::cMaxSize : cChunkSize;
+    const uint64_t step = settings.every ? uint64_t(settings.every) * Signals::Block::cMaxSize : cChunkSize;
+    std::vector<double> rendered(block);
+    for(uint64_t start = 0; start < settings.frames; start += step)
+    {
+        const uint64_t end = std::min<uint64_t>(start + window, settings.frames);
+        renderer.seek(static_cast<int64_t>(start));
+        for(uint64_t first = start; first < end; first += block)
+        {
+            // One block at a time, its memos stay in the graph until the next one
+            const size_t size = static_cast<size_t>(std::min<uint64_t>(block, end - first));
+            renderer.render(std::span(rendered.data(), size));
+            const auto& current = renderer.getBlock();
+            for(auto& shadow : shadows)
+            {
+                auto wide = shadow.signal->memoized<double>(current);
+                auto narrow = shadow.signal->memoized<float>(current);
+                // Only read at control rate or outside the memos in this render, nothing its consumers share
+                if(settings.precision == Precision::Float ? !narrow : !wide)
+                    continue;
+                for(size_t i = 0; i < size; ++i)
+                {
+                    const int64_t sample = static_cast<int64_t>(first + i);
+                    const double seen = settings.precision == Precision::Float ? double(narrow->data[i]) : wide->data[i];
+                    accumulate(shadow.entry, shadow.squares, sample, seen, (*shadow.expected)->get(static_cast<double>(sample)));
+                }
+            }
+        }
+    }
+    for(auto& shadow : shadows)
+    {
+        if(!shadow.entry.samples)
+            continue;
+        shadow.entry.rmsError = std::sqrt(shadow.squares / double(shadow.entry.samples));
+        entries.push_back(std::move(shadow.entry));
+    }
+    return entries;
+}
+
+void Verifier::WriteCSV(std::ostream& out, const std::vector<VerifyEntry>& entries)
+{
+    out << "id,root,type,samples,max_error,max_error_at,rms_error,first_divergent,tolerance,passed\n";
+    for(auto& entry : entries)
+    {
+        out << entry.id << ',' << entry.root << ',' << entry.type << ',' << entry.samples << ',' << entry.maxError << ',' << entry.maxErrorAt << ','
+            << entry.rmsError << ',' << entry.firstDivergent << ',' << entry.tolerance << ',' << (entry.passed() ? 1 : 0) << '\n';
+    }
+}
+
+// Infinite errors, from NaN on one side, have no JSON number
+static void writeError(std::ostream& out, double value)
+{
+    if(std::isfinite(value))
+        Json::writeNumber(out, value);
+    else
+        out << "null";
+}
+
+void Verifier::WriteJson(std::ostream& out, const std::vector<VerifyEntry>& entries)
+{
+    const bool passed = std::all_of(entries.begin(), entries.end(), [](const VerifyEntry& entry) { return entry.passed(); });
+    out << "{\n  \"passed\": " << (passed ? "true" : "false") << ",\n  \"nodes\": [";
+    for(size_t i = 0; i < entries.size(); ++i)
+    {
+        auto& entry = entries[i];
+        out << (i ? ",\n" : "\n") << "    {\"id\": " << entry.id << ", \"root\": " << entry.root << ", \"type\": ";
+        Json::writeString(out, entry.type);
+        out << ", \"samples\": " << entry.samples << ", \"max_error\": ";
+        writeError(out, entry.maxError);
+        out << ", \"max_error_at\": " << entry.maxErrorAt << ", \"rms_error\": ";
+        writeError(out, entry.rmsError);
+        out << ", \"first_divergent\": " << entry.firstDivergent << ", \"tolerance\": ";
+        Json::writeNumber(out, entry.tolerance);
+        out << ", \"passed\": " << (entry.passed() ? "true" : "false") << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+bool Verifier::Save(const std::string& path, const std::vector<VerifyEntry>& entries)
+{
+    std::ofstream file(path);
+    if(!file)
+    {
+        std::print(stderr, "Failed to create file: {}\n", path);
+        return false;
+    }
+    if(path.ends_with(".json"))
+        WriteJson(file, entries);
+    else
+        WriteCSV(file, entries);
+    return file.good();
+}
+}// namespace DSP
@@ -0,0 +1,85 @@
+#ifndef VERIFIER_HPP
+#define VERIFIER_HPP
+
+#include <cstdint>
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <ostream>
+
+#include "Graph/Graph.hpp"
+#include "Render/Renderer.hpp"
+
+namespace DSP
+{
+struct VerifyEntry
+{
+    uint32_t id = 0;
+    uint32_t root = 0;              // Output node whose render the node was read in, 0 when rendered on its own
+    std::string type;
+    uint64_t samples = 0;           // compared
+    double maxError = 0.0;          // absolute
+    double rmsError = 0.0;
+    int64_t maxErrorAt = -1;
+    int64_t firstDivergent = -1;    // first sample past the tolerance, -1 when there is none
+    double tolerance = 0.0;
+
+    bool passed() const { return firstDivergent < 0; }
+};
+
+/**
+ * @class Verifier
+ * @brief Shadow renders every node of a graph through the block engine and through get() and compares them
+ *
+ * get() is the reference. Every node is rendered on its own from sample 0, so stateful nodes stream
+ * exactly as they do in a render. In sampled mode the block engine seeks from window to window and
+ * get() is only evaluated inside them; stateful signals pre-roll to every window either way. A sample
+ * diverges when its error is above the tolerance of the accuracy tier, scaled by the reference's
+ * magnitude above 1.
+ *
+ * A second pass renders every Output node and checks each node upstream of it against get() as
+ * its consumers in that render read it, out of the node's block memo. That covers nodes sharing
+ * memoized inputs with the rest of the graph, where a buffer overwritten while another consumer
+ * still reads it shows up, and a node rendered on its own never shares anything.
+ */
+class Verifier
+{
+public:
+    using Tolerances = std::array<double, 3>;   // by Accuracy
+    static constexpr Tolerances cDefaultTolerances{1e-9, 1e-6, 1e-3};
+    // The float engine rounds every operation, no tier is tighter than this with Precision::Float
+    static constexpr double cFloatTolerance = 1e-5;
+
+    struct Settings
+    {
+        uint64_t frames = 0;
+        Precision precision = Precision::Double;
+        Accuracy accuracy = Accuracy::Exact;
+        bool periodCache = true;
+        uint32_t every = 0;     // compares one window of Block::cMaxSize frames every `every` windows, 0 compares all frames
+        Tolerances tolerances = cDefaultTolerances;
+
+        double tolerance() const;
+    };
+
+    // "exact=<t>,high=<t>,fast=<t>", any subset, the rest kept from base
+    static std::optional<Tolerances> ParseTolerances(std::string_view spec, Tolerances base = cDefaultTolerances);
+
+    // Every node with its own signal, sinks skipped since they share their input's, then every node in every Output's render
+    static std::vector<VerifyEntry> Run(const GraphDesc& desc, const Settings& settings);
+
+    static void WriteCSV(std::ostream& out, const std::vector<VerifyEntry>& entries);
+    static void WriteJson(std::ostream& out, const std::vector<VerifyEntry>& entries);
+    // JSON for *.json paths, CSV otherwise
+    static bool Save(const std::string& path, const std::vector<VerifyEntry>& entries);
+private:
+    // Renders slot from sample 0 and checks it against expected's get()
+    static VerifyEntry Compare(const GraphDesc::Node& node, const SignalSlot& slot, const SignalSlot& expected, const Settings& settings);
+    // Renders the Output node from sample 0 and checks every node upstream of it, as memoized in that render, against its get()
+    static std::vector<VerifyEntry> CompareInContext(const GraphDesc& desc, uint32_t output, const Settings& settings);
+};
+}// namespace DSP
+
+#endif
@@ -0,0 +1,138 @@
+#include "VoiceEngine.hpp"
+
+#include <cmath>
+#include <format>
+#include <algorithm>
+
+#include "Signals/Signals.hpp"
+
+namespace DSP
+{
+VoiceEngine::VoiceEngine(const GraphDesc& voice, uint32_t node, uint32_t voices, Precision precision, Accuracy accuracy) :
+    graph(voice),
+    voices(std::clamp<uint32_t>(voices, 1, cMaxVoices))
+{
+    auto& outputs = graph.getOutputs();
+    if(outputs.empty())
+    {
+        error = "graph has no Output node";
+        return;
+    }
+    const uint32_t nodeId = node ? node : outputs.front();
+    if(std::find(outputs.begin(), outputs.end(), nodeId) == outputs.end())
+    {
+        error = std::format("node {} is not an Output node", nodeId);
+        return;
+    }
+
+    pitch = std::make_shared<Signals::LaneConstant>(std::vector<double>(this->voices, NoteFrequency(69)));
+    auto pitchSlot = std::make_shared<std::shared_ptr<Signals::SignalBase>>(pitch);
+    size_t routed = 0;
+    for(auto& desc : graph.getDesc().nodes)
+    {
+        if(desc.type != Signal)
+            continue;
+        const bool linked = std::any_of(voice.links.begin(), voice.links.end(), [&desc](const GraphDesc::Link& link) {
+            return link.to == desc.id && link.port == FrequencyPort;
+        });
+        if(linked)
+            continue;
+        (*graph.getSignal(desc.id))->getData().freq = pitchSlot;
+        routed++;
+    }
+    if(!routed)
+    {
+        error = "no Signal node has a free Frequency input for the voice pitch";
+        return;
+    }
+    graph.adoptSignals();
+
+    renderer.emplace(graph.getSignal(nodeId), 0, this->voices, precision, accuracy);
+    if(!renderer->isValid())
+        error = std::format("Output node {} is not connected or has an unconnected input upstream", nodeId);
+}
+
+double VoiceEngine::NoteFrequency(double note)
+{
+    return 440.0 * std::exp2((note - 69.0) / 12.0);
+}
+
+uint32_t VoiceEngine::getActiveVoices() const
+{
+    uint32_t active = 0;
+    for(uint32_t voice = 0; voice < voices; ++voice)
+        active += held[voice] || level[voice] > 0.0;
+    return active;
+}
+
+uint32_t VoiceEngine::noteOn(uint8_t note, double velocity)
+{
+    // Lower rank wins: free voices, then released ones by loudness, then held ones by age
+    auto rank = [this](uint32_t voice) {
+        if(held[voice])
+            return 2.0 + 1.0 / double(noteCount + 1 - started[voice]);
+        return level[voice] > 0.0 ? 1.0 + level[voice] / 2.0 : 0.0;
+    };
+    uint32_t chosen = 0;
+    for(uint32_t voice = 1; voice < voices; ++voice)
+    {
+        if(rank(voice) < rank(chosen))
+            chosen = voice;
+    }
+    notes[chosen] = note;
+    held[chosen] = true;
+    target[chosen] = std::clamp(velocity, 0.0, 1.0);
+    started[chosen] = ++noteCount;
+    pitch->set(chosen, NoteFrequency(note));
+    return chosen;
+}
+
+void VoiceEngine::noteOff(uint8_t note)
+{
+    for(uint32_t voice = 0; voice < voices; ++voice)
+    {
+        if(held[voice] && notes[voice] == note)
+        {
+            held[voice] = false;
+            target[voice] = 0.0;
+        }
+    }
+}
+
+void VoiceEngine::allNotesOff()
+{
+    held.fill(false);
+    target.fill(0.0);
+}
+
+void VoiceEngine::render(std::span<float> out)
+{
+    if(!isValid())
+    {
+        std::fill(out.begin(), out.end(), 0.0f);
+        return;
+    }
+    // Silent stateless voices don't have to be rendered, nothing carries over to the next note
+    if(!getActiveVoices() && !renderer->getCheckpoints().isStateful())
+    {
+        std::fill(out.begin(), out.end(), 0.0f);
+        renderer->seek(renderer->getPosition() + static_cast<int64_t>(out.size()));
+        return;
+    }
+
+    laneBuffer.resize(out.size() * voices);
+    renderer->render(laneBuffer);
+    constexpr double step = 1.0 / cRampFrames;
+    for(size_t i = 0; i < out.size(); ++i)
+    {
+        const float* frame = laneBuffer.data() + i * voices;
+        double sum = 0.0;
+        for(uint32_t voice = 0; voice < voices; ++voice)
+        {
+            level[voice] = std::clamp(target[voice], level[voice] - step, level[voice] + step);
+            sum += frame[voice] * level[voice];
+        }
+        out[i] = static_cast<float>(sum);
+    }
+}
+}// namespace DSP
@@ -0,0 +1,74 @@
+#ifndef VOICEENGINE_HPP
+#define VOICEENGINE_HPP
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <span>
+#include <string>
+#include <memory>
+#include <optional>
+
+#include "Graph/Graph.hpp"
+#include "Render/Renderer.hpp"
+
+namespace DSP
+{
+namespace Signals
+{
+    class LaneConstant;
+}
+
+/**
+ * @class VoiceEngine
+ * @brief Plays a graph polyphonically, every voice is one lane of a single render
+ *
+ * The graph is the voice template. Signal nodes with nothing linked to their Frequency input
+ * follow the voice pitch, read from one LaneConstant holding the frequency of every voice.
+ * Voices render together with their lanes interleaved per sample, so every node runs its inner
+ * loop across all voices at once, and whatever doesn't depend on the pitch is computed once.
+ * Per-voice state lives in parallel arrays indexed by lane.
+ */
+class VoiceEngine
+{
+public:
+    static constexpr uint32_t cMaxVoices = 16;
+    static constexpr uint32_t cRampFrames = 256;    // attack and release of the voice gain, avoids clicks
+
+    VoiceEngine(const GraphDesc& voice, uint32_t node = 0, uint32_t voices = 8,
+        Precision precision = Precision::Double, Accuracy accuracy = Accuracy::Exact);
+
+    bool isValid() const { return error.empty(); }
+    const std::string& getError() const { return error; }
+    Graph& getGraph() { return graph; }
+    uint32_t getVoices() const { return voices; }
+    uint32_t getActiveVoices() const;
+    int64_t getPosition() const { return renderer ? renderer->getPosition() : 0; }
+
+    // Takes a free voice, else the quietest released one, else the oldest held one; returns its lane
+    uint32_t noteOn(uint8_t note, double velocity = 1.0);
+    void noteOff(uint8_t note);
+    void allNotesOff();
+
+    // Mono mix of every voice
+    void render(std::span<float> out);
+
+    static double NoteFrequency(double note);
+private:
+    Graph graph;
+    std::string error;
+    uint32_t voices = 0;
+    std::shared_ptr<Signals::LaneConstant> pitch;
+    std::optional<Renderer> renderer;
+    std::vector<float> laneBuffer;
+
+    uint64_t noteCount = 0;
+    std::array<double, cMaxVoices> level{};     // gain applied to the voice right now
+    std::array<double, cMaxVoices> target{};    // velocity while held, 0 once released
+    std::array<uint64_t, cMaxVoices> started{}; // noteCount at noteOn, the age used for stealing
+    std::array<uint8_t, cMaxVoices> notes{};
+    std::array<bool, cMaxVoices> held{};
+};
+}// namespace DSP
+
+#endif
@@ -0,0 +1,207 @@
+#include "Automation.hpp"
+
+#include <cmath>
+#include <bit>
+#include <limits>
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <print>
+
+namespace DSP
+{
+namespace Signals
+{
+static bool parseNumber(std::string_view str, double& value)
+{
+    auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc() && end == str.data() + str.size() && std::isfinite(value);
+}
+
+static std::string_view trim(std::string_view str)
+{
+    const size_t first = str.find_first_not_of(' ');
+    if(first == std::string_view::npos)
+        return {};
+    return str.substr(first, str.find_last_not_of(' ') - first + 1);
+}
+
+std::optional<std::vector<Automation::Breakpoint>> Automation::Parse(std::string_view text)
+{
+    std::vector<Breakpoint> points;
+    while(!trim(text).empty())
+    {
+        const size_t comma = text.find(',');
+        const std::string_view item = trim(text.substr(0, comma));
+        const size_t colon = item.find(':');
+        const size_t second = colon == std::string_view::npos ? colon : item.find(':', colon + 1);
+        Breakpoint point;
+        bool valid = colon != std::string_view::npos &&
+            parseNumber(trim(item.substr(0, colon)), point.time) &&
+            parseNumber(trim(item.substr(colon + 1, second - colon - 1)), point.value);
+        if(valid && second != std::string_view::npos)
+        {
+            const std::string_view curve = trim(item.substr(second + 1));
+            point.curve = curve == "exp" ? Curve::Exponential : Curve::Linear;
+            valid = curve == "exp" || curve == "lin";
+        }
+        if(!valid)
+        {
+            std::print(stderr, "Invalid breakpoint '{}', expected <seconds>:<value>[:lin|exp]\n", item);
+            return std::nullopt;
+        }
+        points.push_back(point);
+        text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+    }
+    return points;
+}
+
+std::string Automation::Format(const std::vector<Breakpoint>& points)
+{
+    std::string text;
+    for(auto& point : points)
+    {
+        text += std::format("{}{}:{}", text.empty() ? "" : ",", point.time, point.value);
+        if(point.curve == Curve::Exponential)
+            text += ":exp";
+    }
+    return text;
+}
+
+void Automation::setPoints(std::vector<Breakpoint> newPoints)
+{
+    points = std::move(newPoints);
+    std::stable_sort(points.begin(), points.end(), [](const Breakpoint& a, const Breakpoint& b) { return a.time < b.time; });
+    build();
+}
+
+void Automation::setSampleRate(double newRate)
+{
+    if(newRate == rate)
+        return;
+    rate = newRate;
+    build();
+}
+
+void Automation::build()
+{
+    segments.clear();
+    blockCursor = sampleCursor = 0;
+    constexpr double cNever = -std::numeric_limits<double>::infinity();
+    if(points.empty())
+    {
+        segments.push_back({cNever, 0.0, 0.0, false});
+        return;
+    }
+    segments.push_back({cNever, points.front().value, 0.0, false});
+    for(size_t k = 1; k < points.size(); ++k)
+    {
+        const Breakpoint& a = points[k - 1];
+        const Breakpoint& b = points[k];
+        const double start = a.time * rate;
+        const double length = b.time * rate - start;
+        // Points at the same time step straight to the later one
+        if(!(length > 0.0))
+            continue;
+        const bool exponential = b.curve == Curve::Exponential && a.value * b.value > 0.0 && a.value != b.value;
+        const double slope = exponential ? std::log(b.value / a.value) / length : (b.value - a.value) / length;
+        segments.push_back({start, a.value, slope, exponential});
+    }
+    segments.push_back({points.back().time * rate, points.back().value, 0.0, false});
+}
+
+size_t Automation::seek(double x, size_t& cursor) const
+{
+    cursor = std::min(cursor, segments.size() - 1);
+    while(cursor + 1 < segments.size() && x >= segments[cursor + 1].start)
+        ++cursor;
+    while(cursor > 0 && x < segments[cursor].start)
+        --cursor;
+    return cursor;
+}
+
+uint64_t Automation::parameterHash() const
+{
+    uint64_t hash = std::bit_cast<uint64_t>(rate);
+    for(auto& point : points)
+    {
+        hash = mixFingerprint(hash, std::bit_cast<uint64_t>(point.time));
+        hash = mixFingerprint(hash, std::bit_cast<uint64_t>(point.value));
+        hash = mixFingerprint(hash, static_cast<uint64_t>(point.curve));
+    }
+    return hash;
+}
+
+std::optional<SignalBase::Periodicity> Automation::periodicity() const
+{
+    const bool flat = std::all_of(points.begin(), points.end(), [this](const Breakpoint& point) {
+        return point.value == points.front().value;
+    });
+    if(!flat)
+        return std::nullopt;
+    return Periodicity{1, mixFingerprint(selfFingerprint(), std::bit_cast<uint64_t>(segments.front().from))};
+}
+
+double Automation::get(double x)
+{
+    const Segment& segment = segments[seek(x, sampleCursor)];
+    if(segment.slope == 0.0)
+        return segment.from;
+    const double offset = x - segment.start;
+    return segment.exponential ? segment.from * std::exp(segment.slope * offset) : segment.from + segment.slope * offset;
+}
+
+template<Accuracy A, class T>
+void Automation::renderAt(const Block& block, T* out)
+{
+    const double stride = block.stride;
+    for(size_t i = 0, count = 0; i < block.size; i += count)
+    {
+        const double x = block.x(i);
+        const size_t k = seek(x, blockCursor);
+        const Segment& segment = segments[k];
+        count = block.size - i;
+        if(k + 1 < segments.size())
+        {
+            // Up to the next breakpoint, estimated and then settled with the same comparison seek() makes
+            const double next = segments[k + 1].start;
+            count = std::clamp<size_t>(static_cast<size_t>(std::max(std::ceil((next - x) / stride), 1.0)), 1, count);
+            while(count > 1 && block.x(i + count - 1) >= next)
+                --count;
+            while(i + count < block.size && block.x(i + count) < next)
+                ++count;
+        }
+
+        T* __restrict y = out + i;
+        const int n = static_cast<int>(count);
+        if(segment.slope == 0.0)
+            std::fill_n(y, count, static_cast<T>(segment.from));
+        else if(segment.exponential)
+        {
+            for(int j = 0; j < n; ++j)
+                y[j] = static_cast<T>(segment.from * FastMath::exp<A>(segment.slope * (x + j * stride - segment.start)));
+        }
+        else
+        {
+            for(int j = 0; j < n; ++j)
+                y[j] = static_cast<T>(segment.from + segment.slope * (x + j * stride - segment.start));
+        }
+    }
+}
+
+template<class T>
+bool Automation::render(const Block& block, T* out)
+{
+    switch(block.accuracy)
+    {
+        case Accuracy::Exact: renderAt<Accuracy::Exact>(block, out); break;
+        case Accuracy::High: renderAt<Accuracy::High>(block, out); break;
+        case Accuracy::Fast: renderAt<Accuracy::Fast>(block, out); break;
+    }
+    return false;
+}
+
+template bool Automation::render(const Block&, double*);
+template bool Automation::render(const Block&, float*);
+}// namespace Signals
+}// namespace DSP
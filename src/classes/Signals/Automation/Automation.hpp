@@ -0,0 +1,93 @@
+#ifndef AUTOMATION_HPP
+#define AUTOMATION_HPP
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <optional>
+
+#include "Signals/Signals.hpp"
+
+extern const uint32_t SAMPLE_RATE;
+
+namespace DSP
+{
+namespace Signals
+{
+    /**
+     * @class Automation
+     * @brief Breakpoint curve over time, linear or exponential between the points
+     *
+     * Before the first point and after the last one the value holds. A block is split at the
+     * breakpoints it crosses and every piece is one closed form ramp, found by stepping a cursor
+     * from the previous block instead of searching per sample. Pieces that hold are plain fills,
+     * so a curve that changes over minutes costs next to nothing, and one that never changes loops
+     * as a one sample period.
+     */
+    class Automation : public SignalBase
+    {
+    public:
+        enum class Curve : int32_t
+        {
+            Linear,
+            Exponential     // constant ratio per second, linear where the values differ in sign or one is 0
+        };
+        struct Breakpoint
+        {
+            double time = 0.0;      // seconds
+            double value = 0.0;
+            Curve curve = Curve::Linear;    // of the segment that ends at this point
+            bool operator==(const Breakpoint&) const = default;
+        };
+
+        Automation(std::vector<Breakpoint> points = {}) : SignalBase(nullptr) { setPoints(std::move(points)); }
+        Automation(const Automation& other) :
+            SignalBase(nullptr),
+            points(other.points),
+            rate(other.rate),
+            segments(other.segments)
+        {}
+
+        // "<seconds>:<value>[:exp],...", the curve of the segment ending at the point
+        static std::optional<std::vector<Breakpoint>> Parse(std::string_view text);
+        static std::string Format(const std::vector<Breakpoint>& points);
+
+        double get(double x) override;
+        ProcessImplementation
+
+        // Sorted by time, points at the same time make a step
+        void setPoints(std::vector<Breakpoint> newPoints);
+        const std::vector<Breakpoint>& getPoints() const { return points; }
+        void setSampleRate(double newRate) override;
+        uint64_t parameterHash() const override;
+        std::optional<Periodicity> periodicity() const override;
+    private:
+        CloneImplimentation(Automation);
+        template<class T>
+        bool render(const Block& block, T* out);
+        template<Accuracy A, class T>
+        void renderAt(const Block& block, T* out);
+
+        // From `start` up to the next segment's start, in samples: from + slope * (x - start),
+        // or from * exp(slope * (x - start)) when exponential
+        struct Segment
+        {
+            double start;
+            double from;
+            double slope;
+            bool exponential;
+        };
+        void build();
+        // Segment holding x, moving cursor there
+        size_t seek(double x, size_t& cursor) const;
+
+        std::vector<Breakpoint> points;
+        double rate = SAMPLE_RATE;
+        std::vector<Segment> segments;  // the first one starts at -inf
+        size_t blockCursor = 0;
+        size_t sampleCursor = 0;
+    };
+}// namespace Signals
+}// namespace DSP
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef BLOCK_HPP
+#define BLOCK_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include "Math/FastMath.hpp"
+
+namespace DSP
+{
+namespace Signals
+{
+    /**
+     * @brief Range of samples rendered in one process() call
+     *
+     * Every block carries `lanes` parallel variants of the graph (sweep points, voices).
+     * Varying buffers are interleaved: value of sample i in lane l is at [i * lanes + l].
+     * Uniform buffers hold one value per sample, shared by all lanes.
+     * `accuracy` picks the tier of the transcendental functions nodes evaluate.
+     * `index` is unique per rendered block across all renderers, nodes memoize their output on it;
+     * 0 marks a block outside any render, which is never memoized.
+     * A `stride` above 1 samples every stride-th x only, that is how control rate inputs are rendered.
+     * With `loopPeriods` periodic signals copy the block out of one cached period instead of computing it.
+     */
+    struct Block
+    {
+        static constexpr uint32_t cMaxSize = 256;
+        // Samples between two evaluations of a control rate input
+        static constexpr uint32_t cControlInterval = 32;
+
+        int64_t start = 0;
+        uint32_t size = 0;
+        uint32_t lanes = 1;
+        uint64_t index = 0;
+        Accuracy accuracy = Accuracy::Exact;
+        uint32_t stride = 1;
+        bool loopPeriods = true;
+
+        // Sample clock of the i-th value; x is the same in double, exact up to 2^53 samples
+        int64_t sample(size_t i) const { return start + static_cast<int64_t>(i * stride); }
+        double x(size_t i) const { return static_cast<double>(sample(i)); }
+        size_t count(bool varying) const { return varying ? size_t(size) * lanes : size; }
+    };
+
+    /**
+     * @brief Read view of a processed input: uniform (one value per sample) or varying per lane
+     */
+    template<class T>
+    struct BasicLanes
+    {
+        const T* data = nullptr;
+        bool varying = false;
+
+        T operator()(size_t i, size_t lane, size_t lanes) const { return varying ? data[i * lanes + lane] : data[i]; }
+    };
+    using Lanes = BasicLanes<double>;
+
+    /**
+     * @brief Evaluates func(x, inputs...) for every sample, once per lane only if an input varies
+     * @return true when the result is varying
+     */
+    template<class T, class Func, class... Inputs>
+    bool mapLanes(const Block& block, T* out, Func&& func, const Inputs&... inputs)
+    {
+        const bool varying = (inputs.varying || ...);
+        if(!varying)
+        {
+            for(size_t i = 0; i < block.size; ++i)
+                out[i] = func(block.x(i), inputs.data[i]...);
+            return false;
+        }
+        const size_t lanes = block.lanes;
+        for(size_t i = 0; i < block.size; ++i)
+        {
+            const double x = block.x(i);
+            for(size_t lane = 0; lane < lanes; ++lane)
+                out[i * lanes + lane] = func(x, inputs(i, lane, lanes)...);
+        }
+        return true;
+    }
+}// namespace Signals
+}// namespace DSP
+
+#endif
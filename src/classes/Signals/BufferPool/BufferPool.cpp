@@ -0,0 +1,109 @@
+#include "BufferPool.hpp"
+
+#include <new>
+#include <algorithm>
+
+namespace DSP
+{
+namespace Signals
+{
+void BufferPool::Buffer::reset()
+{
+    if(pool)
+        pool->release(memory, bytes);
+    pool = nullptr;
+    memory = nullptr;
+    bytes = 0;
+}
+
+BufferPool::Buffer BufferPool::acquire(size_t bytes)
+{
+    const size_t sizeClass = classOf(bytes);
+    const size_t classBytes = size_t(1) << sizeClass;
+    std::lock_guard lock(mutex);
+    void* memory = nullptr;
+    if(auto& list = freeLists[sizeClass]; !list.empty())
+    {
+        memory = list.back();
+        list.pop_back();
+        stats.pooled -= classBytes;
+        stats.reuses++;
+    }
+    else
+    {
+        freeUntilFits(classBytes);
+        if(stats.budget && stats.inUse + stats.pooled + classBytes > stats.budget)
+            stats.overBudget++;
+        memory = ::operator new(classBytes, std::align_val_t(cAlignment));
+        stats.allocations++;
+    }
+    stats.inUse += classBytes;
+    stats.peak = std::max(stats.peak, stats.inUse + stats.pooled);
+    return Buffer(this, memory, classBytes);
+}
+
+void BufferPool::release(void* memory, size_t bytes)
+{
+    std::lock_guard lock(mutex);
+    stats.inUse -= bytes;
+    if(stats.budget && stats.inUse + stats.pooled + bytes > stats.budget)
+    {
+        freeMemory(memory, bytes);
+        return;
+    }
+    freeLists[classOf(bytes)].push_back(memory);
+    stats.pooled += bytes;
+}
+
+void BufferPool::freeUntilFits(size_t bytes)
+{
+    // Largest classes first, they are the least likely to be asked for again
+    for(size_t sizeClass = cClasses; sizeClass-- > 0 && stats.budget && stats.inUse + stats.pooled + bytes > stats.budget;)
+    {
+        auto& list = freeLists[sizeClass];
+        while(!list.empty() && stats.inUse + stats.pooled + bytes > stats.budget)
+        {
+            stats.pooled -= size_t(1) << sizeClass;
+            freeMemory(list.back(), size_t(1) << sizeClass);
+            list.pop_back();
+        }
+    }
+}
+
+void BufferPool::freeMemory(void* memory, size_t bytes)
+{
+    ::operator delete(memory, bytes, std::align_val_t(cAlignment));
+}
+
+void BufferPool::setBudget(size_t bytes)
+{
+    std::lock_guard lock(mutex);
+    stats.budget = bytes;
+    freeUntilFits(0);
+}
+
+void BufferPool::trim()
+{
+    std::lock_guard lock(mutex);
+    for(size_t sizeClass = 0; sizeClass < cClasses; ++sizeClass)
+    {
+        for(void* memory : freeLists[sizeClass])
+            freeMemory(memory, size_t(1) << sizeClass);
+        freeLists[sizeClass].clear();
+    }
+    stats.pooled = 0;
+}
+
+BufferPool::Stats BufferPool::getStats() const
+{
+    std::lock_guard lock(mutex);
+    return stats;
+}
+
+const std::shared_ptr<BufferPool>& BufferPool::Default()
+{
+    static const std::shared_ptr<BufferPool> pool = std::make_shared<BufferPool>();
+    return pool;
+}
+}// namespace Signals
+}// namespace DSP
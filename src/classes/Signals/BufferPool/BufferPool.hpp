@@ -0,0 +1,119 @@
+#ifndef BUFFERPOOL_HPP
+#define BUFFERPOOL_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <array>
+#include <bit>
+#include <utility>
+#include <algorithm>
+
+namespace DSP
+{
+namespace Signals
+{
+    /**
+     * @class BufferPool
+     * @brief Aligned scratch memory for the block engine, handed out in power of two size classes and reused
+     *
+     * Signals take their block buffers, memoized outputs and period caches from the pool of their
+     * graph, so a graph's memory is counted in one place. A returned buffer goes back to the free
+     * list of its class instead of the heap. Past the budget, free buffers are released first;
+     * requests that still don't fit are served anyway, audio doesn't stop, and counted in overBudget.
+     * The pool is locked per acquire and release only, which happens when a buffer grows, not per block.
+     */
+    class BufferPool
+    {
+    public:
+        static constexpr size_t cAlignment = 64;    // a cache line, also covers every SIMD register width
+        static constexpr size_t cMinBytes = 256;
+        static constexpr size_t cClasses = 48;
+
+        /**
+         * @brief Owning handle of one pooled allocation, gives it back when destroyed
+         */
+        class Buffer
+        {
+        public:
+            Buffer() = default;
+            Buffer(Buffer&& other) noexcept { *this = std::move(other); }
+            Buffer& operator=(Buffer&& other) noexcept
+            {
+                if(this != &other)
+                {
+                    reset();
+                    pool = std::exchange(other.pool, nullptr);
+                    memory = std::exchange(other.memory, nullptr);
+                    bytes = std::exchange(other.bytes, 0);
+                }
+                return *this;
+            }
+            ~Buffer() { reset(); }
+
+            template<class T>
+            T* data() const { return static_cast<T*>(memory); }
+            template<class T>
+            size_t capacity() const { return bytes / sizeof(T); }
+            size_t getBytes() const { return bytes; }
+            void reset();
+        private:
+            friend class BufferPool;
+            Buffer(BufferPool* pool, void* memory, size_t bytes) : pool(pool), memory(memory), bytes(bytes) {}
+
+            BufferPool* pool = nullptr;
+            void* memory = nullptr;
+            size_t bytes = 0;
+        };
+
+        struct Stats
+        {
+            size_t budget = 0;          // bytes, 0 is unlimited
+            size_t inUse = 0;           // bytes held by buffers
+            size_t pooled = 0;          // bytes on the free lists
+            size_t peak = 0;            // highest inUse + pooled
+            uint64_t allocations = 0;   // served by the heap
+            uint64_t reuses = 0;        // served from a free list
+            uint64_t overBudget = 0;    // served although they didn't fit the budget
+        };
+
+        BufferPool(size_t budget = 0) { stats.budget = budget; }
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+        // Every Buffer has to be gone by now
+        ~BufferPool() { trim(); }
+
+        Buffer acquire(size_t bytes);
+        // Room for count values of T in buffer, the contents are dropped when it has to grow
+        template<class T>
+        T* ensure(Buffer& buffer, size_t count)
+        {
+            if(buffer.capacity<T>() < count)
+                buffer = acquire(count * sizeof(T));
+            return buffer.data<T>();
+        }
+
+        void setBudget(size_t bytes);
+        // Frees the free lists
+        void trim();
+        Stats getStats() const;
+
+        // Pool of signals that don't belong to a Graph
+        static const std::shared_ptr<BufferPool>& Default();
+    private:
+        static size_t classOf(size_t bytes) { return std::bit_width(std::max(bytes, cMinBytes) - 1); }
+        void release(void* memory, size_t bytes);
+        // Caller holds mutex
+        void freeUntilFits(size_t bytes);
+        void freeMemory(void* memory, size_t bytes);
+
+        mutable std::mutex mutex;
+        std::array<std::vector<void*>, cClasses> freeLists;
+        Stats stats;
+    };
+}// namespace Signals
+}// namespace DSP
+
+#endif
@@ -0,0 +1,108 @@
+#include "Convolution.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+#include "WAVController/WAVController.hpp"
+
+namespace DSP
+{
+namespace Signals
+{
+std::shared_ptr<const ConvolutionKernel> Convolution::LoadKernel(const std::string& path)
+{
+    auto taps = WAVController::ReadWAVFile(path);
+    if(!taps || taps->empty())
+        return nullptr;
+    return std::make_shared<const ConvolutionKernel>(std::move(*taps));
+}
+
+void Convolution::setKernel(std::shared_ptr<const ConvolutionKernel> newKernel)
+{
+    kernel = std::move(newKernel);
+    sampleConvolver.reset();
+    laneConvolvers.clear();
+    nextSample = nextStart = -1;
+}
+
+double Convolution::get(double x)
+{
+    const int64_t sample = static_cast<int64_t>(std::floor(x));
+    if(!kernel || sample < 0)
+        return 0.0;
+    if(!sampleConvolver)
+        sampleConvolver.emplace(kernel);
+
+    float out = 0.0f;
+    if(sample != nextSample)
+    {
+        // Older input is out of the kernel's reach, so replaying this much restores the exact state
+        sampleConvolver->reset();
+        const int64_t taps = static_cast<int64_t>(kernel->getTaps().size());
+        for(int64_t i = std::max<int64_t>(0, sample - taps + 1); i < sample; ++i)
+        {
+            const float in = static_cast<float>((*input)->get(static_cast<double>(i)));
+            sampleConvolver->process(&in, &out, 1);
+        }
+    }
+    const float in = static_cast<float>((*input)->get(x));
+    sampleConvolver->process(&in, &out, 1);
+    nextSample = sample + 1;
+    return out;
+}
+
+void Convolution::saveState(StateBuffer& state) const
+{
+    state.write(nextStart);
+    state.write(lanesVarying);
+    state.write(laneConvolvers.size());
+    for(auto& convolver : laneConvolvers)
+        convolver.saveState(state);
+}
+
+void Convolution::loadState(StateBuffer& state)
+{
+    size_t channels = 0;
+    state.read(nextStart);
+    state.read(lanesVarying);
+    state.read(channels);
+    laneConvolvers.assign(channels, Convolver(kernel));
+    for(auto& convolver : laneConvolvers)
+        convolver.loadState(state);
+}
+
+template<class T>
+bool Convolution::render(const Block& block, T* out)
+{
+    auto in = pull<T>(input, block);
+    if(!kernel)
+    {
+        std::fill_n(out, block.size, T(0));
+        return false;
+    }
+
+    const size_t channels = in.varying ? block.lanes : 1;
+    if(block.start != nextStart || in.varying != lanesVarying || laneConvolvers.size() != channels)
+    {
+        laneConvolvers.assign(channels, Convolver(kernel));
+        lanesVarying = in.varying;
+    }
+    nextStart = block.start + block.size;
+
+    float* laneIn = blockBuffer<float>(0, block.size);
+    float* laneOut = blockBuffer<float>(1, block.size);
+    for(size_t lane = 0; lane < channels; ++lane)
+    {
+        for(size_t i = 0; i < block.size; ++i)
+            laneIn[i] = static_cast<float>(in(i, lane, channels));
+        laneConvolvers[lane].process(laneIn, laneOut, block.size);
+        for(size_t i = 0; i < block.size; ++i)
+            out[i * channels + lane] = laneOut[i];
+    }
+    return in.varying;
+}
+
+template bool Convolution::render(const Block&, double*);
+template bool Convolution::render(const Block&, float*);
+}// namespace Signals
+}// namespace DSP
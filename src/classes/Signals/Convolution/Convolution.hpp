@@ -0,0 +1,71 @@
+#ifndef CONVOLUTION_HPP
+#define CONVOLUTION_HPP
+
+#include <string>
+#include <optional>
+
+#include "Signals/Signals.hpp"
+#include "Convolver.hpp"
+
+namespace DSP
+{
+namespace Signals
+{
+    /**
+     * @class Convolution
+     * @brief FIR filter of the input signal with an impulse response kernel
+     *
+     * Both paths stream: process() continues from the previous block and get() from the
+     * previous sample. Any other position restarts the filter; get() replays the kernel length
+     * of input first so random access stays exact, process() starts from silence.
+     */
+    class Convolution : public SignalBase
+    {
+    public:
+        Convolution(std::shared_ptr<const ConvolutionKernel> kernel = nullptr) : SignalBase(nullptr), kernel(std::move(kernel)) {}
+        Convolution(const Convolution& other) : SignalBase(nullptr), input(other.input), kernel(other.kernel) {}
+
+        static std::shared_ptr<const ConvolutionKernel> LoadKernel(const std::string& path);
+
+        bool isValid() const override
+        {
+            return input && (*input) && (*input)->isValid();
+        }
+        double get(double x) override;
+        SignalData& getData() override
+        {
+            return (*input)->getData();
+        }
+        ProcessImplementation
+
+        bool isStateful() const override { return true; }
+        void saveState(StateBuffer& state) const override;
+        void loadState(StateBuffer& state) override;
+        void visitInputs(const InputVisitor& visit) const override
+        {
+            visit(input);
+        }
+
+        void setInput(const std::shared_ptr<std::shared_ptr<SignalBase>>& newInput) { input = newInput; }
+        const std::shared_ptr<std::shared_ptr<SignalBase>>& getInput() const { return input; }
+        void setKernel(std::shared_ptr<const ConvolutionKernel> newKernel);
+        const std::shared_ptr<const ConvolutionKernel>& getKernel() const { return kernel; }
+        uint64_t parameterHash() const override { return kernel ? kernel->getHash() : 0; }
+    private:
+        CloneImplimentation(Convolution);
+        template<class T>
+        bool render(const Block& block, T* out);
+
+        std::shared_ptr<std::shared_ptr<SignalBase>> input;
+        std::shared_ptr<const ConvolutionKernel> kernel;
+
+        std::optional<Convolver> sampleConvolver;
+        int64_t nextSample = -1;
+        std::vector<Convolver> laneConvolvers;
+        bool lanesVarying = false;
+        int64_t nextStart = -1;
+    };
+}// namespace Signals
+}// namespace DSP
+
+#endif
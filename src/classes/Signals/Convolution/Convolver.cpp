@@ -0,0 +1,215 @@
+#include "Convolver.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace DSP
+{
+namespace Signals
+{
+ConvolutionKernel::ConvolutionKernel(std::vector<float> taps) :
+    taps(std::move(taps))
+{
+    hash = 0xCBF29CE484222325ull;
+    for(float tap : this->taps)
+        hash = (hash ^ std::bit_cast<uint32_t>(tap)) * 0x100000001B3ull;
+
+    const size_t length = this->taps.size();
+    const size_t headLength = length <= cDirectTaps ? length : cHeadTaps;
+    head.assign(this->taps.rbegin() + (length - headLength), this->taps.rend());
+
+    size_t offset = headLength;
+    size_t size = cHeadTaps;
+    std::vector<float> padded;
+    while(offset < length)
+    {
+        Stage stage;
+        stage.offset = offset;
+        stage.size = size;
+        stage.partitions = std::min((length - offset + size - 1) / size, cPartitionsPerStage);
+        stage.fft = &FFT::Get(2 * size);
+
+        const size_t bins = size + 1;
+        stage.spectraRe.resize(stage.partitions * bins);
+        stage.spectraIm.resize(stage.partitions * bins);
+        padded.assign(2 * size, 0.0f);
+        for(size_t k = 0; k < stage.partitions; ++k)
+        {
+            const size_t first = offset + k * size;
+            const size_t count = std::min(size, length - first);
+            std::fill(padded.begin(), padded.end(), 0.0f);
+            std::copy_n(this->taps.begin() + first, count, padded.begin());
+            stage.fft->forward(padded.data(), stage.spectraRe.data() + k * bins, stage.spectraIm.data() + k * bins);
+        }
+
+        offset += stage.partitions * size;
+        stages.push_back(std::move(stage));
+        // A stage of size S needs its first tap at least S samples in; offset grows by 4S per stage so it always is
+        size *= 4;
+    }
+}
+
+Convolver::Convolver(std::shared_ptr<const ConvolutionKernel> kernel) :
+    kernel(std::move(kernel)),
+    states(this->kernel->getStages().size())
+{
+    const auto& stages = this->kernel->getStages();
+    for(size_t i = 0; i < stages.size(); ++i)
+    {
+        const auto& stage = stages[i];
+        auto& state = states[i];
+        const size_t bins = stage.size + 1;
+        state.input.resize(2 * stage.size);
+        state.historyRe.resize(stage.partitions * bins);
+        state.historyIm.resize(stage.partitions * bins);
+        state.accRe.resize(bins);
+        state.accIm.resize(bins);
+        // Whole chunks, so a stage result is always written contiguously
+        state.output.resize((stage.offset / stage.size + 1) * stage.size);
+    }
+    line.resize(std::max<size_t>(this->kernel->getHead().size(), 1) - 1 + ConvolutionKernel::cHeadTaps);
+}
+
+void Convolver::reset()
+{
+    for(auto& state : states)
+    {
+        std::fill(state.input.begin(), state.input.end(), 0.0f);
+        std::fill(state.historyRe.begin(), state.historyRe.end(), 0.0f);
+        std::fill(state.historyIm.begin(), state.historyIm.end(), 0.0f);
+        std::fill(state.output.begin(), state.output.end(), 0.0f);
+        state.historyPos = 0;
+    }
+    std::fill(line.begin(), line.end(), 0.0f);
+    position = 0;
+}
+
+void Convolver::saveState(StateBuffer& state) const
+{
+    for(auto& stage : states)
+    {
+        state.write(stage.input);
+        state.write(stage.historyRe);
+        state.write(stage.historyIm);
+        state.write(stage.output);
+        state.write(stage.historyPos);
+    }
+    state.write(line);
+    state.write(position);
+}
+
+void Convolver::loadState(StateBuffer& state)
+{
+    for(auto& stage : states)
+    {
+        state.read(stage.input);
+        state.read(stage.historyRe);
+        state.read(stage.historyIm);
+        state.read(stage.output);
+        state.read(stage.historyPos);
+    }
+    state.read(line);
+    state.read(position);
+}
+
+void Convolver::process(const float* in, float* out, size_t count)
+{
+    // Segments never cross a multiple of the smallest partition, where stages run
+    constexpr size_t segment = ConvolutionKernel::cHeadTaps;
+    while(count > 0)
+    {
+        const size_t n = std::min(count, segment - position % segment);
+        processSegment(in, out, n);
+        in += n;
+        out += n;
+        count -= n;
+    }
+}
+
+void Convolver::processSegment(const float* in, float* out, size_t count)
+{
+    const auto& head = kernel->getHead();
+    const size_t taps = head.size();
+    const size_t keep = std::max<size_t>(taps, 1) - 1;
+
+    std::copy_n(in, count, line.begin() + keep);
+    // Taps outer, samples inner: the inner loop has no reduction, so it vectorizes without fast-math
+    const float* __restrict h = head.data();
+    float* __restrict y = out;
+    std::fill_n(y, count, 0.0f);
+    for(size_t j = 0; j < taps; ++j)
+    {
+        const float* __restrict x = line.data() + j;
+        const float tap = h[j];
+        for(size_t i = 0; i < count; ++i)
+            y[i] += tap * x[i];
+    }
+    std::copy(line.begin() + count, line.begin() + count + keep, line.begin());
+
+    const auto& stages = kernel->getStages();
+    for(size_t s = 0; s < stages.size(); ++s)
+    {
+        const auto& stage = stages[s];
+        auto& state = states[s];
+        std::copy_n(in, count, state.input.begin() + stage.size + position % stage.size);
+
+        if(position + count <= stage.offset)
+            continue;
+        const size_t first = position < stage.offset ? stage.offset - position : 0;
+        const size_t ring = state.output.size();
+        size_t read = (position + first - stage.offset) % ring;
+        for(size_t i = first; i < count; ++i)
+        {
+            out[i] += state.output[read];
+            if(++read == ring)
+                read = 0;
+        }
+    }
+
+    position += count;
+    for(size_t s = 0; s < stages.size(); ++s)
+        if(position % stages[s].size == 0)
+            runStage(s);
+}
+
+void Convolver::runStage(size_t index)
+{
+    const auto& stage = kernel->getStages()[index];
+    auto& state = states[index];
+    const size_t size = stage.size;
+    const size_t bins = size + 1;
+
+    float* __restrict xRe = state.historyRe.data() + state.historyPos * bins;
+    float* __restrict xIm = state.historyIm.data() + state.historyPos * bins;
+    stage.fft->forward(state.input.data(), xRe, xIm);
+
+    float* __restrict accRe = state.accRe.data();
+    float* __restrict accIm = state.accIm.data();
+    std::fill_n(accRe, bins, 0.0f);
+    std::fill_n(accIm, bins, 0.0f);
+    for(size_t k = 0; k < stage.partitions; ++k)
+    {
+        const size_t slot = (state.historyPos + stage.partitions - k) % stage.partitions;
+        const float* __restrict hRe = stage.spectraRe.data() + k * bins;
+        const float* __restrict hIm = stage.spectraIm.data() + k * bins;
+        const float* __restrict sRe = state.historyRe.data() + slot * bins;
+        const float* __restrict sIm = state.historyIm.data() + slot * bins;
+        for(size_t b = 0; b < bins; ++b)
+        {
+            accRe[b] += hRe[b] * sRe[b] - hIm[b] * sIm[b];
+            accIm[b] += hRe[b] * sIm[b] + hIm[b] * sRe[b];
+        }
+    }
+    state.historyPos = (state.historyPos + 1) % stage.partitions;
+
+    // Overlap-save: the first half of the circular result is aliased, the second half is this chunk.
+    // The finished input half becomes the previous half of the next chunk.
+    std::copy_n(state.input.begin() + size, size, state.input.begin());
+    std::vector<float>& result = scratch;
+    result.resize(2 * size);
+    stage.fft->inverse(accRe, accIm, result.data());
+    const size_t chunk = position / size - 1;
+    std::copy_n(result.begin() + size, size, state.output.begin() + (chunk * size) % state.output.size());
+}
+}// namespace Signals
+}// namespace DSP
@@ -0,0 +1,91 @@
+#ifndef CONVOLVER_HPP
+#define CONVOLVER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "FFT/FFT.hpp"
+#include "Signals/State.hpp"
+
+namespace DSP
+{
+namespace Signals
+{
+    /**
+     * @class ConvolutionKernel
+     * @brief Read-only FIR kernel split into a direct head and frequency-domain partitions
+     *
+     * The first cHeadTaps taps are applied directly. The rest are covered by stages of at most
+     * cPartitionsPerStage uniform partitions whose size grows 4x per stage (Gardner-style
+     * non-uniform partitioned overlap-save), so the stage count grows with log N. Every stage
+     * starts at least one partition into the kernel, so the sum has no latency. Kernels of at
+     * most cDirectTaps taps are applied directly only.
+     */
+    class ConvolutionKernel
+    {
+    public:
+        static constexpr size_t cHeadTaps = 64;
+        static constexpr size_t cDirectTaps = 128;
+        static constexpr size_t cPartitionsPerStage = 4;
+
+        struct Stage
+        {
+            size_t offset;      // first tap
+            size_t size;        // partition size, FFT size is twice that
+            size_t partitions;
+            const FFT* fft;
+            std::vector<float> spectraRe, spectraIm;    // partitions * (size + 1)
+        };
+
+        ConvolutionKernel(std::vector<float> taps);
+
+        const std::vector<float>& getTaps() const { return taps; }
+        const std::vector<float>& getHead() const { return head; }
+        const std::vector<Stage>& getStages() const { return stages; }
+        // FNV-1a over the tap bits, identifies the kernel's content
+        uint64_t getHash() const { return hash; }
+    private:
+        std::vector<float> taps;
+        uint64_t hash = 0;
+        std::vector<float> head;    // reversed, so the direct sum walks both arrays forward
+        std::vector<Stage> stages;
+    };
+
+    /**
+     * @class Convolver
+     * @brief Streaming state of one channel running a ConvolutionKernel
+     */
+    class Convolver
+    {
+    public:
+        Convolver(std::shared_ptr<const ConvolutionKernel> kernel);
+
+        void process(const float* in, float* out, size_t count);
+        void reset();
+        // The state is only valid for the same kernel
+        void saveState(StateBuffer& state) const;
+        void loadState(StateBuffer& state);
+    private:
+        struct StageState
+        {
+            std::vector<float> input;               // previous and current chunk, 2 * size
+            std::vector<float> historyRe, historyIm;  // spectra of the last partitions inputs, ring
+            std::vector<float> accRe, accIm;
+            std::vector<float> output;              // ring of stage results read offset samples later
+            size_t historyPos = 0;
+        };
+
+        void processSegment(const float* in, float* out, size_t count);
+        void runStage(size_t index);
+
+        std::shared_ptr<const ConvolutionKernel> kernel;
+        std::vector<StageState> states;
+        std::vector<float> scratch;
+        std::vector<float> line;    // last head taps - 1 inputs followed by the current segment
+        size_t position = 0;        // samples processed since reset
+    };
+}// namespace Signals
+}// namespace DSP
+
+#endif
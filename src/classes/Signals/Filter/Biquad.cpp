@@ -0,0 +1,145 @@
+#include "Biquad.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace DSP
+{
+namespace Signals
+{
+BiquadCoefficients BiquadCoefficients::Design(Type type, double freq, double q, double gainDb, double sampleRate)
+{
+    freq = std::clamp(freq, 1.0, 0.49 * sampleRate);
+    q = std::max(q, 0.01);
+    const double w0 = 2.0 * M_PI * freq / sampleRate;
+    const double cosW = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double A = std::pow(10.0, gainDb / 40.0);
+    const double shelf = 2.0 * std::sqrt(A) * alpha;
+
+    double b0, b1, b2, a0, a1, a2;
+    switch(type)
+    {
+        case Type::LowPass:
+            b0 = (1.0 - cosW) / 2.0; b1 = 1.0 - cosW; b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cosW; a2 = 1.0 - alpha;
+            break;
+        case Type::HighPass:
+            b0 = (1.0 + cosW) / 2.0; b1 = -(1.0 + cosW); b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cosW; a2 = 1.0 - alpha;
+            break;
+        case Type::BandPass:
+            b0 = alpha; b1 = 0.0; b2 = -alpha;
+            a0 = 1.0 + alpha; a1 = -2.0 * cosW; a2 = 1.0 - alpha;
+            break;
+        case Type::Notch:
+            b0 = 1.0; b1 = -2.0 * cosW; b2 = 1.0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cosW; a2 = 1.0 - alpha;
+            break;
+        case Type::Peak:
+            b0 = 1.0 + alpha * A; b1 = -2.0 * cosW; b2 = 1.0 - alpha * A;
+            a0 = 1.0 + alpha / A; a1 = -2.0 * cosW; a2 = 1.0 - alpha / A;
+            break;
+        case Type::LowShelf:
+            b0 = A * ((A + 1.0) - (A - 1.0) * cosW + shelf);
+            b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosW);
+            b2 = A * ((A + 1.0) - (A - 1.0) * cosW - shelf);
+            a0 = (A + 1.0) + (A - 1.0) * cosW + shelf;
+            a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosW);
+            a2 = (A + 1.0) + (A - 1.0) * cosW - shelf;
+            break;
+        case Type::HighShelf:
+            b0 = A * ((A + 1.0) + (A - 1.0) * cosW + shelf);
+            b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosW);
+            b2 = A * ((A + 1.0) + (A - 1.0) * cosW - shelf);
+            a0 = (A + 1.0) - (A - 1.0) * cosW + shelf;
+            a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosW);
+            a2 = (A + 1.0) - (A - 1.0) * cosW - shelf;
+            break;
+        default:
+            return {};
+    }
+    return {b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0};
+}
+
+void BiquadCascade::resize(size_t sections, size_t channels)
+{
+    this->sections = sections;
+    this->channels = channels;
+    b0.assign(channels, 1.0);
+    b1.assign(channels, 0.0);
+    b2.assign(channels, 0.0);
+    a1.assign(channels, 0.0);
+    a2.assign(channels, 0.0);
+    z1.assign(sections * channels, 0.0);
+    z2.assign(sections * channels, 0.0);
+    frame.resize(channels);
+}
+
+void BiquadCascade::reset()
+{
+    std::fill(z1.begin(), z1.end(), 0.0);
+    std::fill(z2.begin(), z2.end(), 0.0);
+}
+
+void BiquadCascade::saveState(StateBuffer& state) const
+{
+    state.write(sections);
+    for(auto* values : {&b0, &b1, &b2, &a1, &a2, &z1, &z2})
+        state.write(*values);
+}
+
+void BiquadCascade::loadState(StateBuffer& state)
+{
+    state.read(sections);
+    for(auto* values : {&b0, &b1, &b2, &a1, &a2, &z1, &z2})
+        state.read(*values);
+    channels = b0.size();
+    frame.resize(channels);
+}
+
+void BiquadCascade::setCoefficients(size_t channel, const BiquadCoefficients& coefficients)
+{
+    b0[channel] = coefficients.b0;
+    b1[channel] = coefficients.b1;
+    b2[channel] = coefficients.b2;
+    a1[channel] = coefficients.a1;
+    a2[channel] = coefficients.a2;
+}
+
+void BiquadCascade::process(const double* in, double* out, size_t count)
+{
+    const size_t n = channels;
+    const double* __restrict cb0 = b0.data();
+    const double* __restrict cb1 = b1.data();
+    const double* __restrict cb2 = b2.data();
+    const double* __restrict ca1 = a1.data();
+    const double* __restrict ca2 = a2.data();
+    double* __restrict x = frame.data();
+    for(size_t i = 0; i < count; ++i)
+    {
+        std::copy_n(in + i * n, n, x);
+        for(size_t s = 0; s < sections; ++s)
+        {
+            double* __restrict s1 = z1.data() + s * n;
+            double* __restrict s2 = z2.data() + s * n;
+            for(size_t c = 0; c < n; ++c)
+            {
+                const double y = cb0[c] * x[c] + s1[c];
+                s1[c] = cb1[c] * x[c] - ca1[c] * y + s2[c];
+                s2[c] = cb2[c] * x[c] - ca2[c] * y;
+                x[c] = y;
+            }
+        }
+        std::copy_n(x, n, out + i * n);
+    }
+}
+
+void BiquadCascade::flushDenormals()
+{
+    for(auto* state : {&z1, &z2})
+        for(double& z : *state)
+            z = std::abs(z) < cDenormalThreshold ? 0.0 : z;
+}
+}// namespace Signals
+}// namespace DSP
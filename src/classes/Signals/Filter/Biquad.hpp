@@ -0,0 +1,74 @@
+#ifndef BIQUAD_HPP
+#define BIQUAD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Signals/State.hpp"
+
+namespace DSP
+{
+namespace Signals
+{
+    /**
+     * @brief Normalized biquad coefficients (a0 == 1), designed after the RBJ audio EQ cookbook
+     */
+    struct BiquadCoefficients
+    {
+        enum class Type : int32_t
+        {
+            LowPass,
+            HighPass,
+            BandPass,
+            Notch,
+            Peak,
+            LowShelf,
+            HighShelf
+        };
+
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+
+        // freq and sampleRate in Hz, gainDb only affects Peak and the shelves
+        static BiquadCoefficients Design(Type type, double freq, double q, double gainDb, double sampleRate);
+    };
+
+    /**
+     * @class BiquadCascade
+     * @brief Identical biquad sections in series for several channels at once
+     *
+     * State and coefficients are stored per channel in contiguous arrays and every section
+     * steps all channels in one loop, so lanes of a block are filtered in parallel.
+     * Sections use the transposed direct form II.
+     */
+    class BiquadCascade
+    {
+    public:
+        static constexpr double cDenormalThreshold = 1e-30;
+
+        BiquadCascade(size_t sections = 1, size_t channels = 1) { resize(sections, channels); }
+
+        // Clears the state
+        void resize(size_t sections, size_t channels);
+        void reset();
+        void saveState(StateBuffer& state) const;
+        void loadState(StateBuffer& state);
+        size_t getSections() const { return sections; }
+        size_t getChannels() const { return channels; }
+
+        void setCoefficients(size_t channel, const BiquadCoefficients& coefficients);
+        // in/out: count frames of getChannels() interleaved values, may be the same buffer
+        void process(const double* in, double* out, size_t count);
+        // Zeroes state that decayed below cDenormalThreshold, before it turns into slow subnormals
+        void flushDenormals();
+    private:
+        size_t sections = 0;
+        size_t channels = 0;
+        std::vector<double> b0, b1, b2, a1, a2;     // per channel
+        std::vector<double> z1, z2;                 // sections * channels
+        std::vector<double> frame;
+    };
+}// namespace Signals
+}// namespace DSP
+
+#endif
@@ -0,0 +1,163 @@
+#include "Filter.hpp"
+
+namespace DSP
+{
+namespace Signals
+{
+void Filter::setType(Type newType)
+{
+    type = newType;
+    restart();
+}
+
+void Filter::setSections(size_t newSections)
+{
+    sections = std::clamp<size_t>(newSections, 1, cMaxSections);
+    restart();
+}
+
+void Filter::setSampleRate(double rate)
+{
+    if(rate == sampleRate)
+        return;
+    sampleRate = rate;
+    restart();
+}
+
+void Filter::restart()
+{
+    nextSample = nextStart = -1;
+    sampleCheckpoints.clear();
+}
+
+void Filter::saveState(StateBuffer& state) const
+{
+    state.write(nextStart);
+    state.write(laneParameters);
+    laneCascade.saveState(state);
+}
+
+void Filter::loadState(StateBuffer& state)
+{
+    state.read(nextStart);
+    state.read(laneParameters);
+    laneCascade.loadState(state);
+}
+
+void Filter::updateCoefficients(BiquadCascade& cascade, std::vector<Parameters>& designed, size_t channel, const Parameters& current)
+{
+    if(designed[channel] == current)
+        return;
+    designed[channel] = current;
+    cascade.setCoefficients(channel, BiquadCoefficients::Design(type, current.frequency, current.q, current.gain, sampleRate));
+}
+
+double Filter::get(double x)
+{
+    const int64_t sample = static_cast<int64_t>(std::floor(x));
+    if(sample < 0)
+        return 0.0;
+    if(sample < nextSample || nextSample < 0)
+    {
+        // The state depends on the whole history, so a jump back resumes from the last snapshot before it
+        const size_t k = std::min<size_t>(static_cast<size_t>(sample / cSampleCheckpoint), sampleCheckpoints.size());
+        if(k > 0)
+        {
+            sampleCascade = sampleCheckpoints[k - 1].cascade;
+            sampleParameters.assign(1, sampleCheckpoints[k - 1].parameters);
+            nextSample = static_cast<int64_t>(k) * cSampleCheckpoint;
+        }
+        else
+        {
+            sampleCascade.resize(sections, 1);
+            sampleParameters.assign(1, {NAN, NAN, NAN});
+            sampleCheckpoints.clear();
+            nextSample = 0;
+        }
+    }
+
+    double out = 0.0;
+    for(; nextSample <= sample; ++nextSample)
+    {
+        if(nextSample > 0 && nextSample % cSampleCheckpoint == 0 && size_t(nextSample / cSampleCheckpoint) == sampleCheckpoints.size() + 1)
+            sampleCheckpoints.push_back({sampleCascade, sampleParameters.front()});
+        const double t = static_cast<double>(nextSample);
+        if(nextSample % cControlInterval == 0)
+            updateCoefficients(sampleCascade, sampleParameters, 0, {(*frequency)->get(t), (*q)->get(t), (*gain)->get(t)});
+        const double in = (*input)->get(t);
+        sampleCascade.process(&in, &out, 1);
+        if((nextSample + 1) % cControlInterval == 0)
+            sampleCascade.flushDenormals();
+    }
+    return out;
+}
+
+template<class T>
+bool Filter::render(const Block& block, T* out)
+{
+    auto in = pull<T>(input, block);
+    auto f = pull<T>(frequency, block);
+    auto qValue = pull<T>(q, block);
+    auto g = pull<T>(gain, block);
+
+    const bool varying = in.varying || f.varying || qValue.varying || g.varying;
+    const size_t channels = varying ? block.lanes : 1;
+    if(block.start != nextStart || laneCascade.getChannels() != channels || laneCascade.getSections() != sections)
+    {
+        laneCascade.resize(sections, channels);
+        laneParameters.assign(channels, {NAN, NAN, NAN});
+        // Off the control grid the coefficients come from the grid point before the block, like in get().
+        // A stateful parameter can't be evaluated there without breaking its stream, it is read at the block start
+        constexpr int64_t n = cControlInterval;
+        const int64_t gridStart = floorDiv(block.start, n) * n;
+        if(gridStart != block.start)
+        {
+            Block grid = block;
+            grid.start = gridStart;
+            grid.size = 1;
+            grid.stride = static_cast<uint32_t>(n);
+            auto point = [&grid, this](const std::shared_ptr<std::shared_ptr<SignalBase>>& slot, const BasicLanes<T>& values) {
+                return hasState(slot) ? values : pull<T>(slot, grid);
+            };
+            const auto fPoint = point(frequency, f);
+            const auto qPoint = point(q, qValue);
+            const auto gPoint = point(gain, g);
+            for(size_t channel = 0; channel < channels; ++channel)
+                updateCoefficients(laneCascade, laneParameters, channel, {fPoint(0, channel, channels), qPoint(0, channel, channels), gPoint(0, channel, channels)});
+        }
+    }
+    nextStart = block.start + block.size;
+
+    // The cascade runs in double whatever the block precision
+    double* frames = blockBuffer<double>(0, size_t(block.size) * channels);
+    if(varying && !in.varying)
+    {
+        for(size_t i = 0; i < block.size; ++i)
+            std::fill_n(frames + i * channels, channels, in.data[i]);
+    }
+    else
+        std::copy_n(in.data, size_t(block.size) * channels, frames);
+
+    for(size_t i = 0; i < block.size;)
+    {
+        const int64_t position = block.start + static_cast<int64_t>(i);
+        const size_t phase = static_cast<size_t>(position % cControlInterval);
+        const size_t count = std::min<size_t>(block.size - i, cControlInterval - phase);
+        if(phase == 0)
+        {
+            for(size_t channel = 0; channel < channels; ++channel)
+                updateCoefficients(laneCascade, laneParameters, channel, {f(i, channel, channels), qValue(i, channel, channels), g(i, channel, channels)});
+        }
+        laneCascade.process(frames + i * channels, frames + i * channels, count);
+        if(phase + count == cControlInterval)
+            laneCascade.flushDenormals();
+        i += count;
+    }
+    std::copy_n(frames, size_t(block.size) * channels, out);
+    return varying;
+}
+
+template bool Filter::render(const Block&, double*);
+template bool Filter::render(const Block&, float*);
+}// namespace Signals
+}// namespace DSP
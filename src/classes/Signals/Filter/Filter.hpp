@@ -0,0 +1,128 @@
+#ifndef FILTER_HPP
+#define FILTER_HPP
+
+#include <cmath>
+#include <bit>
+
+#include "Signals/Signals.hpp"
+#include "Biquad.hpp"
+
+namespace DSP
+{
+namespace Signals
+{
+    /**
+     * @class Filter
+     * @brief Biquad cascade over the input signal with modulatable frequency, Q and gain
+     *
+     * Parameters are read at control rate, on every cControlInterval-th sample, so both paths
+     * see the same coefficients. process() continues from the previous block and restarts from
+     * silence anywhere else, seeking is up to the renderer's checkpoints. get() runs forward from
+     * the previous sample and resumes from its own snapshots on a jump back.
+     */
+    class Filter : public SignalBase
+    {
+    public:
+        static constexpr size_t cControlInterval = 32;
+        static constexpr size_t cMaxSections = 8;
+        using Type = BiquadCoefficients::Type;
+
+        Filter(Type type = Type::LowPass, size_t sections = 1) :
+            SignalBase(nullptr),
+            frequency(std::make_shared<std::shared_ptr<SignalBase>>(std::make_shared<Constant>(1000.0))),
+            q(std::make_shared<std::shared_ptr<SignalBase>>(std::make_shared<Constant>(M_SQRT1_2))),
+            gain(std::make_shared<std::shared_ptr<SignalBase>>(std::make_shared<Constant>(0.0))),
+            type(type),
+            sections(std::clamp<size_t>(sections, 1, cMaxSections))
+        {}
+        Filter(const Filter& other) :
+            SignalBase(nullptr),
+            input(other.input),
+            frequency(other.frequency),
+            q(other.q),
+            gain(other.gain),
+            type(other.type),
+            sections(other.sections),
+            sampleRate(other.sampleRate)
+        {}
+
+        bool isValid() const override
+        {
+            return input && (*input) && (*input)->isValid();
+        }
+        double get(double x) override;
+        ProcessImplementation
+        SignalData& getData() override
+        {
+            return (*input)->getData();
+        }
+
+        bool isStateful() const override { return true; }
+        void saveState(StateBuffer& state) const override;
+        void loadState(StateBuffer& state) override;
+        void visitInputs(const InputVisitor& visit) const override
+        {
+            visit(input);
+            visit(frequency);
+            visit(q);
+            visit(gain);
+        }
+
+        // get() snapshots its state every cSampleCheckpoint samples, so a jump back resumes from there
+        static constexpr int64_t cSampleCheckpoint = 4096;
+
+        void setInput(const std::shared_ptr<std::shared_ptr<SignalBase>>& newInput) { input = newInput; }
+        void setFrequency(const std::shared_ptr<std::shared_ptr<SignalBase>>& newFrequency) { frequency = newFrequency; }
+        void setQ(const std::shared_ptr<std::shared_ptr<SignalBase>>& newQ) { q = newQ; }
+        void setGain(const std::shared_ptr<std::shared_ptr<SignalBase>>& newGain) { gain = newGain; }
+        const std::shared_ptr<std::shared_ptr<SignalBase>>& getInput() const { return input; }
+
+        Type getType() const { return type; }
+        void setType(Type newType);
+        size_t getSections() const { return sections; }
+        void setSections(size_t newSections);
+        // The coefficients are designed for it, the input keeps its own
+        void setSampleRate(double rate) override;
+        uint64_t parameterHash() const override
+        {
+            return mixFingerprint(mixFingerprint(uint64_t(type), sections), std::bit_cast<uint64_t>(sampleRate));
+        }
+    private:
+        CloneImplimentation(Filter);
+        template<class T>
+        bool render(const Block& block, T* out);
+
+        struct Parameters
+        {
+            double frequency, q, gain;
+            bool operator==(const Parameters&) const = default;
+        };
+
+        void restart();
+        void updateCoefficients(BiquadCascade& cascade, std::vector<Parameters>& designed, size_t channel, const Parameters& current);
+
+        std::shared_ptr<std::shared_ptr<SignalBase>> input;
+        std::shared_ptr<std::shared_ptr<SignalBase>> frequency;
+        std::shared_ptr<std::shared_ptr<SignalBase>> q;
+        std::shared_ptr<std::shared_ptr<SignalBase>> gain;
+        Type type;
+        size_t sections;
+        double sampleRate = SAMPLE_RATE;
+
+        // Last designed parameters per channel, coefficients are only recomputed on change
+        std::vector<Parameters> sampleParameters, laneParameters;
+        BiquadCascade sampleCascade;
+        int64_t nextSample = -1;
+        struct SampleCheckpoint
+        {
+            BiquadCascade cascade;
+            Parameters parameters;
+        };
+        std::vector<SampleCheckpoint> sampleCheckpoints;  // state before sample (k + 1) * cSampleCheckpoint
+        BiquadCascade laneCascade;
+        int64_t nextStart = -1;
+    };
+}// namespace Signals
+}// namespace DSP
+
+#endif
@@ -0,0 +1,304 @@
+#include "Bytecode.hpp"
+
+#include <array>
+#include <charconv>
+#include <format>
+#include <numbers>
+
+namespace DSP
+{
+namespace Signals
+{
+/**
+ * @brief Recursive descent over the formula, emitting code as it goes
+ *
+ * A Value is either a folded constant or a register. Constants only become Const instructions
+ * when they meet a register, and temporaries are handed back as soon as they were read.
+ */
+class FormulaParser
+{
+public:
+    FormulaParser(std::string_view text, Bytecode& program) : text(text), program(program) {}
+
+    bool parse(std::string& error)
+    {
+        Value value = expression();
+        skipSpaces();
+        if(failed.empty() && position < text.size())
+            fail(std::format("unexpected '{}'", text[position]));
+        if(failed.empty())
+        {
+            if(value.constant)
+                value = materialize(value);
+            program.result = value.reg;
+        }
+        error = failed;
+        return failed.empty();
+    }
+private:
+    struct Value
+    {
+        bool constant = true;
+        double number = 0.0;
+        uint8_t reg = 0;
+    };
+    using Op = Bytecode::Op;
+
+    Value fail(const std::string& message)
+    {
+        if(failed.empty())
+            failed = std::format("{} at position {}", message, position + 1);
+        return {};
+    }
+
+    void skipSpaces()
+    {
+        while(position < text.size() && (text[position] == ' ' || text[position] == '\t'))
+            ++position;
+    }
+    bool accept(char c)
+    {
+        skipSpaces();
+        if(position < text.size() && text[position] == c)
+        {
+            ++position;
+            return true;
+        }
+        return false;
+    }
+
+    uint8_t allocate()
+    {
+        auto free = std::find(used.begin(), used.end(), false);
+        if(free == used.end())
+        {
+            fail("formula too deep");
+            return Bytecode::cFirstTemporary;
+        }
+        *free = true;
+        const size_t index = free - used.begin();
+        program.temporaries = std::max(program.temporaries, index + 1);
+        return static_cast<uint8_t>(Bytecode::cFirstTemporary + index);
+    }
+    void release(const Value& value)
+    {
+        if(!value.constant && value.reg >= Bytecode::cFirstTemporary)
+            used[value.reg - Bytecode::cFirstTemporary] = false;
+    }
+    Value materialize(const Value& value)
+    {
+        if(!value.constant)
+            return value;
+        const uint8_t reg = allocate();
+        program.code.push_back({Op::Const, reg, 0, 0, value.number});
+        return {false, 0.0, reg};
+    }
+
+    // Binary when b is given; folds constants, otherwise the result gets a register none of the operands has
+    Value emit(Op op, Value a, std::optional<Value> b = std::nullopt)
+    {
+        if(!failed.empty())
+            return {};
+        if(a.constant && (!b || b->constant))
+        {
+            const double right = b ? b->number : a.number;
+            double folded = a.number;
+            Bytecode::dispatch(op, [&](auto o) { folded = Bytecode::apply<decltype(o)::value, Accuracy::Exact>(a.number, right); });
+            return {true, folded, 0};
+        }
+        a = materialize(a);
+        Value right = b ? materialize(*b) : a;
+        const uint8_t out = allocate();
+        program.code.push_back({op, out, a.reg, right.reg, 0.0});
+        release(a);
+        if(b)
+            release(right);
+        return {false, 0.0, out};
+    }
+
+    Value expression()
+    {
+        Value value = term();
+        while(failed.empty())
+        {
+            if(accept('+'))
+                value = emit(Op::Add, value, term());
+            else if(accept('-'))
+                value = emit(Op::Sub, value, term());
+            else
+                break;
+        }
+        return value;
+    }
+
+    Value term()
+    {
+        Value value = unary();
+        while(failed.empty())
+        {
+            if(accept('*'))
+                value = emit(Op::Mul, value, unary());
+            else if(accept('/'))
+                value = emit(Op::Div, value, unary());
+            else if(accept('%'))
+                value = emit(Op::Mod, value, unary());
+            else
+                break;
+        }
+        return value;
+    }
+
+    // Below ^, so -a^2 is -(a^2). Parentheses, arguments and signs all nest through here, so this bounds the recursion
+    Value unary()
+    {
+        if(depth == cMaxDepth)
+            return fail("formula too deep");
+        ++depth;
+        Value value;
+        if(accept('-'))
+            value = emit(Op::Neg, unary());
+        else if(accept('+'))
+            value = unary();
+        else
+            value = power();
+        --depth;
+        return value;
+    }
+
+    Value power()
+    {
+        Value base = primary();
+        if(failed.empty() && accept('^'))
+            return emit(Op::Pow, base, unary());
+        return base;
+    }
+
+    Value primary()
+    {
+        skipSpaces();
+        if(position >= text.size())
+            return fail("unexpected end");
+        const char c = text[position];
+        if(c == '(')
+        {
+            ++position;
+            Value value = expression();
+            if(failed.empty() && !accept(')'))
+                return fail("expected ')'");
+            return value;
+        }
+        if((c >= '0' && c <= '9') || c == '.')
+        {
+            double number;
+            auto [end, ec] = std::from_chars(text.data() + position, text.data() + text.size(), number);
+            if(ec != std::errc())
+                return fail("invalid number");
+            position = end - text.data();
+            return {true, number, 0};
+        }
+        const size_t start = position;
+        while(position < text.size() && ((text[position] >= 'a' && text[position] <= 'z') || (text[position] >= 'A' && text[position] <= 'Z')))
+            ++position;
+        const std::string_view name = text.substr(start, position - start);
+        if(name.empty())
+            return fail(std::format("unexpected '{}'", c));
+        if(accept('('))
+            return call(name, start);
+        if(name == "pi")
+            return {true, std::numbers::pi, 0};
+        if(name == "t")
+        {
+            program.time = true;
+            return {false, 0.0, Bytecode::cTime};
+        }
+        if(name.size() == 1 && name[0] >= 'a' && size_t(name[0] - 'a') < Bytecode::cMaxInputs)
+        {
+            const size_t index = name[0] - 'a';
+            program.inputMask |= 1u << index;
+            program.inputs = std::max(program.inputs, index + 1);
+            return {false, 0.0, static_cast<uint8_t>(index)};
+        }
+        position = start;
+        return fail(std::format("unknown name '{}'", name));
+    }
+
+    Value call(std::string_view name, size_t start)
+    {
+        struct Function
+        {
+            std::string_view name;
+            Op op;
+            size_t arguments;
+        };
+        static constexpr std::array<Function, 14> cFunctions{{
+            {"sin", Op::Sin, 1}, {"cos", Op::Cos, 1}, {"tan", Op::Tan, 1}, {"tanh", Op::Tanh, 1},
+            {"exp", Op::Exp, 1}, {"log", Op::Log, 1}, {"sqrt", Op::Sqrt, 1}, {"abs", Op::Abs, 1},
+            {"floor", Op::Floor, 1}, {"min", Op::Min, 2}, {"max", Op::Max, 2}, {"pow", Op::Pow, 2},
+            {"mod", Op::Mod, 2}, {"clamp", Op::Min, 3}
+        }};
+        auto function = std::find_if(cFunctions.begin(), cFunctions.end(), [name](const Function& f) { return f.name == name; });
+        if(function == cFunctions.end())
+        {
+            position = start;
+            return fail(std::format("unknown function '{}'", name));
+        }
+        std::vector<Value> arguments{expression()};
+        while(failed.empty() && accept(','))
+            arguments.push_back(expression());
+        if(failed.empty() && !accept(')'))
+            return fail("expected ')'");
+        if(failed.empty() && arguments.size() != function->arguments)
+        {
+            position = start;
+            return fail(std::format("{} takes {} argument{}", name, function->arguments, function->arguments == 1 ? "" : "s"));
+        }
+        if(!failed.empty())
+            return {};
+        if(function->arguments == 1)
+            return emit(function->op, arguments[0]);
+        // clamp(x, lo, hi) is min(max(x, lo), hi)
+        if(function->arguments == 3)
+            return emit(Op::Min, emit(Op::Max, arguments[0], arguments[1]), arguments[2]);
+        return emit(function->op, arguments[0], arguments[1]);
+    }
+
+    static constexpr size_t cMaxDepth = 256;
+
+    std::string_view text;
+    Bytecode& program;
+    size_t position = 0;
+    size_t depth = 0;
+    std::string failed;
+    std::array<bool, Bytecode::cMaxTemporaries> used{};
+};
+
+std::optional<Bytecode> Bytecode::Compile(std::string_view text, std::string& error)
+{
+    Bytecode program;
+    FormulaParser parser(text, program);
+    if(!parser.parse(error))
+        return std::nullopt;
+    return program;
+}
+
+double Bytecode::run(const double* in, double t) const
+{
+    double registers[cRegisters];
+    std::copy_n(in, cMaxInputs, registers);
+    registers[cTime] = t;
+    for(auto& instruction : code)
+    {
+        double& out = registers[instruction.out];
+        if(instruction.op == Op::Const)
+        {
+            out = instruction.value;
+            continue;
+        }
+        const double a = registers[instruction.a];
+        const double b = registers[instruction.b];
+        dispatch(instruction.op, [&](auto op) { out = apply<decltype(op)::value, Accuracy::Exact>(a, b); });
+    }
+    return registers[result];
+}
+}// namespace Signals
+}// namespace DSP
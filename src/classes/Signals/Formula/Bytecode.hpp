@@ -0,0 +1,184 @@
+#ifndef BYTECODE_HPP
+#define BYTECODE_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <type_traits>
+
+#include "Math/FastMath.hpp"
+
+namespace DSP
+{
+namespace Signals
+{
+    /**
+     * @class Bytecode
+     * @brief An expression over the inputs a, b, c, ... and the time t, compiled to register code
+     *
+     * Registers are whole block buffers: the first cMaxInputs hold the inputs, then t, then the
+     * temporaries. Every instruction is one loop over the block, so a formula costs a handful of
+     * vectorized passes instead of a node per operation. Constant subexpressions are folded while
+     * compiling, and an instruction never writes a register it reads, so the loops can be __restrict.
+     *
+     * Syntax: numbers, a-h, t (seconds), pi, + - * / % ^, parentheses and the functions
+     * sin cos tan tanh exp log sqrt abs floor of one argument, min max pow mod of two and clamp of three.
+     */
+    class Bytecode
+    {
+    public:
+        static constexpr size_t cMaxInputs = 8;
+        static constexpr size_t cMaxTemporaries = 32;
+        static constexpr uint8_t cTime = cMaxInputs;
+        static constexpr uint8_t cFirstTemporary = cMaxInputs + 1;
+        static constexpr size_t cRegisters = cFirstTemporary + cMaxTemporaries;
+
+        enum class Op : uint8_t
+        {
+            Const,      // fills out with value
+            Neg,
+            Abs,
+            Sqrt,
+            Floor,
+            Exp,
+            Log,
+            Sin,
+            Cos,
+            Tan,
+            Tanh,
+            Add,
+            Sub,
+            Mul,
+            Div,
+            Mod,
+            Pow,
+            Min,
+            Max
+        };
+        struct Instruction
+        {
+            Op op;
+            uint8_t out;
+            uint8_t a;
+            uint8_t b;      // a again for unary ops
+            double value;
+        };
+
+        // nullopt with a message naming the position on a syntax error
+        static std::optional<Bytecode> Compile(std::string_view text, std::string& error);
+        static char InputName(size_t index) { return static_cast<char>('a' + index); }
+
+        // One past the highest input the formula reads
+        size_t getInputs() const { return inputs; }
+        bool usesInput(size_t index) const { return inputMask & (1u << index); }
+        bool usesTime() const { return time; }
+        size_t getTemporaries() const { return temporaries; }
+        uint8_t getResult() const { return result; }
+        const std::vector<Instruction>& getCode() const { return code; }
+
+        // One sample, with the exact functions
+        double run(const double* in, double t) const;
+        // count values of every register; the ones from cFirstTemporary on are written
+        template<Accuracy A, class T>
+        void run(const T* const* registers, T* const* temporaries, size_t count) const;
+    private:
+        friend class FormulaParser;
+
+        template<Op O, Accuracy A, class T>
+        static T apply(T a, T b);
+        // Calls f with the op as a std::integral_constant, the one switch both run()s share
+        template<class F>
+        static void dispatch(Op op, F&& f);
+        template<Op O, Accuracy A, class T>
+        static void loop(T* __restrict out, const T* __restrict a, const T* __restrict b, size_t count);
+
+        std::vector<Instruction> code;
+        uint32_t inputMask = 0;
+        size_t inputs = 0;
+        bool time = false;
+        size_t temporaries = 0;
+        uint8_t result = cFirstTemporary;
+    };
+
+    template<Bytecode::Op O, Accuracy A, class T>
+    inline T Bytecode::apply(T a, T b)
+    {
+        if constexpr(O == Op::Neg) return -a;
+        else if constexpr(O == Op::Abs) return std::abs(a);
+        else if constexpr(O == Op::Sqrt) return std::sqrt(a);
+        else if constexpr(O == Op::Floor) return std::floor(a);
+        else if constexpr(O == Op::Exp) return FastMath::exp<A>(a);
+        else if constexpr(O == Op::Log) return std::log(a);
+        else if constexpr(O == Op::Sin) return FastMath::sin<A>(a);
+        else if constexpr(O == Op::Cos) return FastMath::cos<A>(a);
+        else if constexpr(O == Op::Tan) return std::tan(a);
+        else if constexpr(O == Op::Tanh) return FastMath::tanh<A>(a);
+        else if constexpr(O == Op::Add) return a + b;
+        else if constexpr(O == Op::Sub) return a - b;
+        else if constexpr(O == Op::Mul) return a * b;
+        else if constexpr(O == Op::Div) return a / b;
+        else if constexpr(O == Op::Mod) return FastMath::fmod<A>(a, b);
+        else if constexpr(O == Op::Pow) return std::pow(a, b);
+        else if constexpr(O == Op::Min) return std::min(a, b);
+        else if constexpr(O == Op::Max) return std::max(a, b);
+        else return a;
+    }
+
+    template<class F>
+    inline void Bytecode::dispatch(Op op, F&& f)
+    {
+        switch(op)
+        {
+            case Op::Const: break;
+            case Op::Neg: f(std::integral_constant<Op, Op::Neg>()); break;
+            case Op::Abs: f(std::integral_constant<Op, Op::Abs>()); break;
+            case Op::Sqrt: f(std::integral_constant<Op, Op::Sqrt>()); break;
+            case Op::Floor: f(std::integral_constant<Op, Op::Floor>()); break;
+            case Op::Exp: f(std::integral_constant<Op, Op::Exp>()); break;
+            case Op::Log: f(std::integral_constant<Op, Op::Log>()); break;
+            case Op::Sin: f(std::integral_constant<Op, Op::Sin>()); break;
+            case Op::Cos: f(std::integral_constant<Op, Op::Cos>()); break;
+            case Op::Tan: f(std::integral_constant<Op, Op::Tan>()); break;
+            case Op::Tanh: f(std::integral_constant<Op, Op::Tanh>()); break;
+            case Op::Add: f(std::integral_constant<Op, Op::Add>()); break;
+            case Op::Sub: f(std::integral_constant<Op, Op::Sub>()); break;
+            case Op::Mul: f(std::integral_constant<Op, Op::Mul>()); break;
+            case Op::Div: f(std::integral_constant<Op, Op::Div>()); break;
+            case Op::Mod: f(std::integral_constant<Op, Op::Mod>()); break;
+            case Op::Pow: f(std::integral_constant<Op, Op::Pow>()); break;
+            case Op::Min: f(std::integral_constant<Op, Op::Min>()); break;
+            case Op::Max: f(std::integral_constant<Op, Op::Max>()); break;
+        }
+    }
+
+    template<Bytecode::Op O, Accuracy A, class T>
+    inline void Bytecode::loop(T* __restrict out, const T* __restrict a, const T* __restrict b, size_t count)
+    {
+        for(size_t j = 0; j < count; ++j)
+            out[j] = apply<O, A>(a[j], b[j]);
+    }
+
+    template<Accuracy A, class T>
+    void Bytecode::run(const T* const* registers, T* const* temporaries, size_t count) const
+    {
+        for(auto& instruction : code)
+        {
+            T* out = temporaries[instruction.out - cFirstTemporary];
+            if(instruction.op == Op::Const)
+            {
+                std::fill_n(out, count, static_cast<T>(instruction.value));
+                continue;
+            }
+            const T* a = registers[instruction.a];
+            const T* b = registers[instruction.b];
+            dispatch(instruction.op, [&](auto op) { loop<decltype(op)::value, A>(out, a, b, count); });
+        }
+    }
+}// namespace Signals
+}// namespace DSP
+
+#endif
@@ -0,0 +1,150 @@
+#include "Formula.hpp"
+
+#include <bit>
+#include <algorithm>
+#include <functional>
+
+namespace DSP
+{
+namespace Signals
+{
+// Block buffers after the temporaries: the inputs spread to every lane, then t
+static constexpr size_t cSpreadBuffer = Bytecode::cMaxTemporaries;
+static constexpr size_t cTimeBuffer = cSpreadBuffer + Bytecode::cMaxInputs;
+
+bool Formula::setText(std::string newText)
+{
+    text = std::move(newText);
+    program = Bytecode::Compile(text, error);
+    return program.has_value();
+}
+
+void Formula::setInput(size_t index, const std::shared_ptr<std::shared_ptr<SignalBase>>& input)
+{
+    if(index < cMaxInputs)
+        inputs[index] = input;
+}
+
+bool Formula::isValid() const
+{
+    if(!program)
+        return false;
+    for(size_t k = 0; k < program->getInputs(); ++k)
+    {
+        if(program->usesInput(k) && !(inputs[k] && *inputs[k] && (*inputs[k])->isValid()))
+            return false;
+    }
+    return true;
+}
+
+uint64_t Formula::parameterHash() const
+{
+    return mixFingerprint(std::hash<std::string>()(text), std::bit_cast<uint64_t>(rate));
+}
+
+std::optional<SignalBase::Periodicity> Formula::periodicity() const
+{
+    if(!program || program->usesTime())
+        return std::nullopt;
+    std::optional<Periodicity> period = Periodicity{1, selfFingerprint()};
+    for(size_t k = 0; k < program->getInputs(); ++k)
+    {
+        if(program->usesInput(k))
+            period = combinePeriods(period, periodOf(inputs[k]));
+    }
+    if(period)
+        period->fingerprint = mixFingerprint(period->fingerprint, std::hash<std::string>()(text));
+    return period;
+}
+
+bool Formula::isConnected() const
+{
+    for(size_t k = 0; k < program->getInputs(); ++k)
+    {
+        if(program->usesInput(k) && !(inputs[k] && *inputs[k]))
+            return false;
+    }
+    return true;
+}
+
+double Formula::get(double x)
+{
+    if(!program || !isConnected())
+        return 0.0;
+    double in[cMaxInputs] = {};
+    for(size_t k = 0; k < program->getInputs(); ++k)
+    {
+        if(program->usesInput(k))
+            in[k] = (*inputs[k])->get(x);
+    }
+    return program->run(in, x / rate);
+}
+
+template<class T>
+bool Formula::render(const Block& block, T* out)
+{
+    if(!program || !isConnected())
+    {
+        std::fill_n(out, block.size, T(0));
+        return false;
+    }
+    const Bytecode& code = *program;
+    BasicLanes<T> in[cMaxInputs];
+    bool varying = false;
+    for(size_t k = 0; k < code.getInputs(); ++k)
+    {
+        if(code.usesInput(k))
+        {
+            in[k] = pull<T>(inputs[k], block);
+            varying = varying || in[k].varying;
+        }
+    }
+    const size_t width = varying ? block.lanes : 1;
+    const size_t count = size_t(block.size) * width;
+
+    const T* registers[Bytecode::cRegisters] = {};
+    for(size_t k = 0; k < code.getInputs(); ++k)
+    {
+        if(!code.usesInput(k))
+            continue;
+        if(in[k].varying || width == 1)
+        {
+            registers[k] = in[k].data;
+            continue;
+        }
+        T* spread = blockBuffer<T>(cSpreadBuffer + k, count);
+        for(size_t i = 0; i < block.size; ++i)
+            std::fill_n(spread + i * width, width, in[k].data[i]);
+        registers[k] = spread;
+    }
+    if(code.usesTime())
+    {
+        T* time = blockBuffer<T>(cTimeBuffer, count);
+        for(size_t i = 0; i < block.size; ++i)
+            std::fill_n(time + i * width, width, static_cast<T>(block.x(i) / rate));
+        registers[Bytecode::cTime] = time;
+    }
+    // The result's register is the output itself
+    T* temporaries[Bytecode::cMaxTemporaries];
+    for(size_t k = 0; k < code.getTemporaries(); ++k)
+    {
+        const bool result = Bytecode::cFirstTemporary + k == code.getResult();
+        temporaries[k] = result ? out : blockBuffer<T>(k, count);
+        registers[Bytecode::cFirstTemporary + k] = temporaries[k];
+    }
+
+    switch(block.accuracy)
+    {
+        case Accuracy::Exact: code.run<Accuracy::Exact>(registers, temporaries, count); break;
+        case Accuracy::High: code.run<Accuracy::High>(registers, temporaries, count); break;
+        case Accuracy::Fast: code.run<Accuracy::Fast>(registers, temporaries, count); break;
+    }
+    if(code.getResult() < Bytecode::cFirstTemporary)
+        std::copy_n(registers[code.getResult()], count, out);
+    return varying;
+}
+
+template bool Formula::render(const Block&, double*);
+template bool Formula::render(const Block&, float*);
+}// namespace Signals
+}// namespace DSP
@@ -0,0 +1,82 @@
+#ifndef FORMULA_HPP
+#define FORMULA_HPP
+
+#include <array>
+#include <string>
+#include <optional>
+
+#include "Signals/Signals.hpp"
+#include "Bytecode.hpp"
+
+extern const uint32_t SAMPLE_RATE;
+
+namespace DSP
+{
+namespace Signals
+{
+    /**
+     * @class Formula
+     * @brief A typed expression over up to Bytecode::cMaxInputs inputs and the time t, see Bytecode
+     *
+     * The text is compiled once when it is set; a text that doesn't compile leaves the formula
+     * invalid until the next one does, and pulled anyway it gives silence. Inputs the formula doesn't
+     * read are neither required nor pulled. Uniform inputs stay uniform, a single varying one makes
+     * the whole program run per lane.
+     */
+    class Formula : public SignalBase
+    {
+    public:
+        static constexpr size_t cMaxInputs = Bytecode::cMaxInputs;
+
+        Formula(std::string text = {}) : SignalBase(nullptr) { setText(std::move(text)); }
+        Formula(const Formula& other) :
+            SignalBase(nullptr),
+            inputs(other.inputs),
+            text(other.text),
+            program(other.program),
+            error(other.error),
+            rate(other.rate)
+        {}
+
+        bool isValid() const override;
+        double get(double x) override;
+        ProcessImplementation
+
+        void visitInputs(const InputVisitor& visit) const override
+        {
+            for(auto& input : inputs)
+            {
+                if(input)
+                    visit(input);
+            }
+        }
+        // t is in seconds of this rate
+        void setSampleRate(double newRate) override { rate = newRate; }
+        uint64_t parameterHash() const override;
+        std::optional<Periodicity> periodicity() const override;
+
+        // Compiles text; on failure getError() says why
+        bool setText(std::string newText);
+        const std::string& getText() const { return text; }
+        const std::string& getError() const { return error; }
+        const std::optional<Bytecode>& getProgram() const { return program; }
+        // Input `index` is read as the letter Bytecode::InputName(index)
+        void setInput(size_t index, const std::shared_ptr<std::shared_ptr<SignalBase>>& input);
+        const std::shared_ptr<std::shared_ptr<SignalBase>>& getInput(size_t index) const { return inputs[index]; }
+    private:
+        CloneImplimentation(Formula);
+        template<class T>
+        bool render(const Block& block, T* out);
+        // Every input the program reads is connected, unlike isValid() without asking the inputs themselves
+        bool isConnected() const;
+
+        std::array<std::shared_ptr<std::shared_ptr<SignalBase>>, cMaxInputs> inputs;
+        std::string text;
+        std::optional<Bytecode> program;
+        std::string error;
+        double rate = SAMPLE_RATE;
+    };
+}// namespace Signals
+}// namespace DSP
+
+#endif
@@ -0,0 +1,225 @@
+#include "HalfBand.hpp"
+
+#include <cmath>
+#include <bit>
+#include <algorithm>
+
+namespace DSP
+{
+namespace Signals
+{
+// About 80 dB of stopband attenuation
+static constexpr double cKaiserBeta = 8.0;
+
+static double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for(int k = 1; term > 1e-17 * sum; ++k)
+    {
+        const double factor = x / (2.0 * k);
+        term *= factor * factor;
+        sum += term;
+    }
+    return sum;
+}
+
+HalfBand::HalfBand(size_t pairs) :
+    pairs(std::max<size_t>(pairs, 1)),
+    coefficients(this->pairs)
+{
+    // The window reaches its end one tap past the outermost pair, so that pair keeps some weight
+    const double half = 2.0 * double(this->pairs);
+    double sum = 0.0;
+    for(size_t k = 0; k < this->pairs; ++k)
+    {
+        const double n = double(2 * k + 1);
+        const double ideal = (k % 2 ? -1.0 : 1.0) / (M_PI * n);
+        const double window = besselI0(cKaiserBeta * std::sqrt(1.0 - (n / half) * (n / half))) / besselI0(cKaiserBeta);
+        coefficients[k] = ideal * window;
+        sum += coefficients[k];
+    }
+    // The center tap is 1/2, so a gain of exactly 1 at DC leaves 1/4 for each side
+    for(double& coefficient : coefficients)
+        coefficient *= 0.25 / sum;
+}
+
+void HalfBand::reset(size_t newChannels)
+{
+    channels = std::max<size_t>(newChannels, 1);
+    odd.assign((2 * pairs - 1) * channels, 0.0);
+    even.assign((pairs - 1) * channels, 0.0);
+}
+
+void HalfBand::widen(size_t newChannels)
+{
+    if(channels != 1)
+        return reset(newChannels);
+    auto spread = [newChannels](std::vector<double>& line, size_t history) {
+        std::vector<double> wide(history * newChannels);
+        for(size_t frame = 0; frame < history; ++frame)
+            std::fill_n(wide.data() + frame * newChannels, newChannels, line[frame]);
+        line = std::move(wide);
+    };
+    spread(odd, 2 * pairs - 1);
+    spread(even, pairs - 1);
+    channels = newChannels;
+}
+
+void HalfBand::saveState(StateBuffer& state) const
+{
+    state.write(channels);
+    state.write(odd);
+    state.write(even);
+}
+
+void HalfBand::loadState(StateBuffer& state)
+{
+    state.read(channels);
+    state.read(odd);
+    state.read(even);
+}
+
+void HalfBand::oddPhase(const double* line, size_t count, double gain, double* out) const
+{
+    double* __restrict sum = out;
+    std::fill_n(sum, count, 0.0);
+    for(size_t k = 0; k < pairs; ++k)
+    {
+        const double c = gain * coefficients[k];
+        const double* __restrict a = line + (pairs - 1 - k) * channels;
+        const double* __restrict b = line + (pairs + k) * channels;
+        for(size_t i = 0; i < count; ++i)
+            sum[i] += c * (a[i] + b[i]);
+    }
+}
+
+void HalfBand::keepHistory(std::vector<double>& line, size_t history, size_t frames) const
+{
+    if(frames)
+        std::copy_n(line.begin() + frames * channels, history * channels, line.begin());
+}
+
+void HalfBand::upsample(const double* in, size_t frames, double* out)
+{
+    const size_t history = 2 * pairs - 1;
+    const size_t count = frames * channels;
+    odd.resize((history + frames) * channels);
+    std::copy_n(in, count, odd.data() + history * channels);
+    // Zero stuffing halves the level, the odd phase makes up for it with twice the taps
+    sums.resize(count);
+    oddPhase(odd.data(), count, 2.0, sums.data());
+    const double* delayed = odd.data() + (pairs - 1) * channels;
+    for(size_t m = 0; m < frames; ++m)
+    {
+        std::copy_n(delayed + m * channels, channels, out + 2 * m * channels);
+        std::copy_n(sums.data() + m * channels, channels, out + (2 * m + 1) * channels);
+    }
+    keepHistory(odd, history, frames);
+}
+
+void HalfBand::downsample(const double* in, size_t frames, double* out)
+{
+    const size_t oddHistory = 2 * pairs - 1;
+    const size_t evenHistory = pairs - 1;
+    const size_t count = frames * channels;
+    odd.resize((oddHistory + frames) * channels);
+    even.resize((evenHistory + frames) * channels);
+    double* oddIn = odd.data() + oddHistory * channels;
+    double* evenIn = even.data() + evenHistory * channels;
+    for(size_t m = 0; m < frames; ++m)
+    {
+        std::copy_n(in + 2 * m * channels, channels, evenIn + m * channels);
+        std::copy_n(in + (2 * m + 1) * channels, channels, oddIn + m * channels);
+    }
+    oddPhase(odd.data(), count, 1.0, out);
+    double* __restrict y = out;
+    const double* __restrict center = even.data();
+    for(size_t i = 0; i < count; ++i)
+        y[i] += 0.5 * center[i];
+    keepHistory(odd, oddHistory, frames);
+    keepHistory(even, evenHistory, frames);
+}
+
+HalfBandChain::HalfBandChain(Direction direction, uint32_t factor) :
+    direction(direction),
+    factor(std::bit_floor(std::max<uint32_t>(factor, 1)))
+{
+    const size_t count = std::countr_zero(this->factor);
+    for(size_t s = 0; s < count; ++s)
+        stages.emplace_back(s == 0 ? HalfBand::cSharpPairs : HalfBand::cShortPairs);
+    // Stages are built from the base rate up; decimation runs them from the top down
+    if(direction == Direction::Down)
+        std::reverse(stages.begin(), stages.end());
+}
+
+void HalfBandChain::reset(size_t newChannels)
+{
+    channels = std::max<size_t>(newChannels, 1);
+    for(auto& stage : stages)
+        stage.reset(channels);
+}
+
+void HalfBandChain::widen(size_t newChannels)
+{
+    channels = newChannels;
+    for(auto& stage : stages)
+        stage.widen(newChannels);
+}
+
+int64_t HalfBandChain::getLatency() const
+{
+    int64_t latency = 0;
+    for(size_t s = 0; s < stages.size(); ++s)
+    {
+        const int64_t pairs = static_cast<int64_t>(stages[s].getPairs());
+        if(direction == Direction::Up)
+            latency += 2 * pairs * (factor >> (s + 1));    // pairs input samples, 2 * pairs at the stage's output rate
+        else
+            latency += (2 * pairs - 2) << s;               // at the stage's input rate, factor >> s
+    }
+    return latency;
+}
+
+void HalfBandChain::saveState(StateBuffer& state) const
+{
+    state.write(channels);
+    for(auto& stage : stages)
+        stage.saveState(state);
+}
+
+void HalfBandChain::loadState(StateBuffer& state)
+{
+    state.read(channels);
+    for(auto& stage : stages)
+        stage.loadState(state);
+}
+
+void HalfBandChain::process(const double* in, size_t frames, double* out)
+{
+    if(stages.empty())
+    {
+        std::copy_n(in, frames * channels, out);
+        return;
+    }
+    const double* source = in;
+    size_t count = direction == Direction::Up ? frames : frames * factor;
+    for(size_t s = 0; s < stages.size(); ++s)
+    {
+        const size_t produced = direction == Direction::Up ? count * 2 : count / 2;
+        double* target = out;
+        if(s + 1 < stages.size())
+        {
+            scratch[s % 2].resize(produced * channels);
+            target = scratch[s % 2].data();
+        }
+        if(direction == Direction::Up)
+            stages[s].upsample(source, count, target);
+        else
+            stages[s].downsample(source, produced, target);
+        source = target;
+        count = produced;
+    }
+}
+}// namespace Signals
+}// namespace DSP
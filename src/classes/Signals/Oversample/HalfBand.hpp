@@ -0,0 +1,98 @@
+#ifndef HALFBAND_HPP
+#define HALFBAND_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Signals/State.hpp"
+
+namespace DSP
+{
+namespace Signals
+{
+    /**
+     * @class HalfBand
+     * @brief Kaiser windowed half-band FIR changing the rate by 2, for several interleaved channels at once
+     *
+     * Besides the center tap only every other tap is non-zero, so as a polyphase filter one phase is a
+     * plain delay and the other one symmetric dot product of `pairs` tap pairs. The dot products run
+     * over all frames and channels of a block in one loop per tap pair, which vectorizes for any lane count.
+     */
+    class HalfBand
+    {
+    public:
+        static constexpr size_t cSharpPairs = 16;   // 63 taps, for the octave next to the base rate
+        static constexpr size_t cShortPairs = 4;    // 15 taps, stages further out only see content far below their band edge
+
+        explicit HalfBand(size_t pairs = cSharpPairs);
+
+        // Clears the state
+        void reset(size_t channels);
+        // From one channel to `channels`, every channel continuing with the state of the one
+        void widen(size_t channels);
+        size_t getChannels() const { return channels; }
+        size_t getPairs() const { return pairs; }
+        void saveState(StateBuffer& state) const;
+        void loadState(StateBuffer& state);
+
+        // frames input frames to 2 * frames output frames; output 2m is input m - pairs, 2m + 1 lies halfway to input m - pairs + 1
+        void upsample(const double* in, size_t frames, double* out);
+        // 2 * frames input frames to frames output frames; output m is centered on input 2m - 2 * pairs + 2
+        void downsample(const double* in, size_t frames, double* out);
+    private:
+        // out[i] = gain * sum of the tap pairs around line frame `center` + i / channels, over count values
+        void oddPhase(const double* line, size_t count, double gain, double* out) const;
+        // Moves the last `history` frames of line to its front
+        void keepHistory(std::vector<double>& line, size_t history, size_t frames) const;
+
+        size_t pairs;
+        size_t channels = 0;
+        std::vector<double> coefficients;   // tap pairs at 1, 3, 5, ... from the center
+        std::vector<double> odd;            // upsample: the input; downsample: the odd input phase; 2 * pairs - 1 history frames first
+        std::vector<double> even;           // downsample: the even input phase, pairs - 1 history frames first
+        std::vector<double> sums;
+    };
+
+    /**
+     * @class HalfBandChain
+     * @brief HalfBand stages in series for a factor of 2, 4 or 8
+     *
+     * The stage at the base rate is the sharp one, the others are short. Both directions have a
+     * delay of a whole number of high rate samples, the Oversample nodes shift their input by it.
+     */
+    class HalfBandChain
+    {
+    public:
+        enum class Direction
+        {
+            Up,
+            Down
+        };
+        // Base rate samples that fill the history of every stage, a restart renders them first
+        static constexpr int64_t cPreRoll = 40;
+
+        HalfBandChain(Direction direction, uint32_t factor);
+
+        void reset(size_t channels);
+        void widen(size_t channels);
+        size_t getChannels() const { return channels; }
+        uint32_t getFactor() const { return factor; }
+        // In high rate samples
+        int64_t getLatency() const;
+        void saveState(StateBuffer& state) const;
+        void loadState(StateBuffer& state);
+
+        // Up: frames base rate frames to factor * frames; Down: factor * frames frames to frames
+        void process(const double* in, size_t frames, double* out);
+    private:
+        Direction direction;
+        uint32_t factor;
+        size_t channels = 0;
+        std::vector<HalfBand> stages;       // in processing order
+        std::vector<double> scratch[2];
+    };
+}// namespace Signals
+}// namespace DSP
+
+#endif
@@ -0,0 +1,387 @@
+#include "Oversample.hpp"
+
+#include <cmath>
+#include <bit>
+#include <algorithm>
+#include <unordered_set>
+
+namespace DSP
+{
+namespace Signals
+{
+// Spreads count frames of one channel to `channels` channels, in place
+static void spreadFrames(double* frames, size_t count, size_t channels)
+{
+    for(size_t i = count; i-- > 0;)
+        std::fill_n(frames + i * channels, channels, frames[i]);
+}
+
+// Interleaves count samples of in into channels, the layout the chains work on
+template<class T>
+static void toFrames(const BasicLanes<T>& in, size_t count, size_t channels, double* out)
+{
+    double* __restrict frames = out;
+    for(size_t i = 0; i < count; ++i)
+    {
+        for(size_t c = 0; c < channels; ++c)
+            frames[i * channels + c] = in(i, c, channels);
+    }
+}
+
+// Samples of a block before x = 0, the stages are silent there like the stateful signals' get()
+static size_t silentPrefix(const Block& block)
+{
+    return static_cast<size_t>(std::clamp<int64_t>(-block.start, 0, block.size));
+}
+
+static uint32_t validFactor(uint32_t factor)
+{
+    return std::bit_floor(std::clamp<uint32_t>(factor, 1, Oversample::cMaxFactor));
+}
+
+Oversample::~Oversample()
+{
+    for(auto& weak : enclosed)
+    {
+        if(auto signal = weak.lock())
+            release(*signal);
+    }
+}
+
+void Oversample::setFactor(uint32_t factor)
+{
+    factor = validFactor(factor);
+    if(factor == getFactor())
+        return;
+    chain = HalfBandChain(HalfBandChain::Direction::Down, factor);
+    sampleChain = chain;
+    nextStart = nextSample = INT64_MIN;
+    staged = false;
+}
+
+void Oversample::setStage(double rate, std::vector<uint32_t> factors)
+{
+    if(rate == baseRate && factors == outerFactors)
+        return;
+    baseRate = rate;
+    outerFactors = std::move(factors);
+    staged = false;
+}
+
+double Oversample::outerRate() const
+{
+    double rate = baseRate;
+    for(uint32_t factor : outerFactors)
+        rate *= factor;
+    return rate;
+}
+
+void Oversample::release(SignalBase& signal) const
+{
+    if(auto* inner = dynamic_cast<Oversample*>(&signal))
+        inner->setStage(baseRate, outerFactors);
+    else if(auto* entry = dynamic_cast<OversampleInput*>(&signal))
+        entry->setFactor(1);
+    else
+        signal.setSampleRate(outerRate());
+}
+
+void Oversample::enclose()
+{
+    // Depth d is the rate after the first d factors: outerFactors, then the own one
+    std::vector<uint32_t> factors = outerFactors;
+    factors.push_back(getFactor());
+    std::vector<double> rates{baseRate};
+    for(uint32_t factor : factors)
+        rates.push_back(rates.back() * factor);
+
+    struct Entry
+    {
+        std::shared_ptr<SignalBase> signal;
+        size_t depth;
+    };
+    std::vector<Entry> stack;
+    std::unordered_set<const SignalBase*> visited;
+    std::vector<std::weak_ptr<SignalBase>> retimed;
+    auto push = [&stack](const std::shared_ptr<std::shared_ptr<SignalBase>>& slot, size_t depth) {
+        if(slot && *slot)
+            stack.push_back({*slot, depth});
+    };
+    entries.clear();
+    push(input, factors.size());
+    while(!stack.empty())
+    {
+        auto [signal, depth] = std::move(stack.back());
+        stack.pop_back();
+        if(signal.get() == this || !visited.insert(signal.get()).second)
+            continue;
+        retimed.push_back(signal);
+        if(auto* inner = dynamic_cast<Oversample*>(signal.get()))
+        {
+            // Its own stage is up to its render
+            inner->setStage(baseRate, {factors.begin(), factors.begin() + depth});
+            continue;
+        }
+        if(auto* entry = dynamic_cast<OversampleInput*>(signal.get()))
+        {
+            entry->setFactor(depth ? factors[depth - 1] : 1);
+            if(depth == factors.size())
+                entries.push_back(entry);
+            const size_t outside = depth ? depth - 1 : 0;
+            entry->visitInputs([&push, outside](const auto& slot) { push(slot, outside); });
+            continue;
+        }
+        signal->setSampleRate(rates[depth]);
+        signal->visitInputs([&push, depth](const auto& slot) { push(slot, depth); });
+    }
+
+    for(auto& weak : enclosed)
+    {
+        auto signal = weak.lock();
+        if(signal && !visited.contains(signal.get()))
+            release(*signal);
+    }
+    enclosed = std::move(retimed);
+    staged = true;
+}
+
+void Oversample::saveState(StateBuffer& state) const
+{
+    state.write(nextStart);
+    chain.saveState(state);
+}
+
+void Oversample::loadState(StateBuffer& state)
+{
+    state.read(nextStart);
+    chain.loadState(state);
+}
+
+double Oversample::get(double x)
+{
+    const int64_t sample = static_cast<int64_t>(std::floor(x));
+    if(sample != nextSample)
+    {
+        enclose();
+        sampleChain.reset(1);
+        for(int64_t m = sample - HalfBandChain::cPreRoll; m < sample; ++m)
+            getFrame(m);
+    }
+    nextSample = sample + 1;
+    return getFrame(sample);
+}
+
+double Oversample::getFrame(int64_t sample)
+{
+    const uint32_t factor = getFactor();
+    const int64_t first = sample * factor + sampleChain.getLatency();
+    double frames[cMaxFactor];
+    for(uint32_t r = 0; r < factor; ++r)
+        frames[r] = first + r < 0 ? 0.0 : (*input)->get(static_cast<double>(first + r));
+    double out = 0.0;
+    sampleChain.process(frames, 1, &out);
+    return out;
+}
+
+template<class T>
+void Oversample::advance(const Block& block, int64_t first, size_t count, double* out)
+{
+    const uint32_t factor = getFactor();
+    const size_t part = Block::cMaxSize / factor;
+    const int64_t delay = chain.getLatency();
+    for(size_t done = 0, frames = 0; done < count; done += frames)
+    {
+        frames = std::min(count - done, part);
+        Block stage = block;
+        stage.start = (first + static_cast<int64_t>(done)) * factor + delay;
+        stage.size = static_cast<uint32_t>(frames * factor);
+        const size_t silent = silentPrefix(stage);
+        BasicLanes<T> in;
+        if(silent < stage.size)
+        {
+            Block heard = stage;
+            heard.start += static_cast<int64_t>(silent);
+            heard.size -= static_cast<uint32_t>(silent);
+            in = pull<T>(input, heard);
+        }
+        if(in.varying && chain.getChannels() == 1 && block.lanes > 1)
+        {
+            chain.widen(block.lanes);
+            spreadFrames(out, done, block.lanes);
+        }
+
+        const size_t channels = chain.getChannels();
+        double* wide = blockBuffer<double>(2, stage.size * channels);
+        std::fill_n(wide, silent * channels, 0.0);
+        if(silent < stage.size)
+            toFrames(in, stage.size - silent, channels, wide + silent * channels);
+        chain.process(wide, frames, out + done * channels);
+    }
+}
+
+template<class T>
+bool Oversample::render(const Block& block, T* out)
+{
+    if(block.stride != 1)
+        return SignalBase::process(block, out);
+
+    const bool restart = block.start != nextStart || (chain.getChannels() != 1 && chain.getChannels() != block.lanes);
+    // The walk allocates, contiguous blocks of an unchanged stage reuse the last one
+    if(restart || !staged)
+        enclose();
+    for(auto* entry : entries)
+        entry->setSource(block);
+    if(restart)
+    {
+        chain.reset(1);
+        double* history = blockBuffer<double>(1, HalfBandChain::cPreRoll * block.lanes);
+        advance<T>(block, block.start - HalfBandChain::cPreRoll, HalfBandChain::cPreRoll, history);
+    }
+    nextStart = block.start + block.size;
+
+    double* frames = blockBuffer<double>(0, size_t(block.size) * block.lanes);
+    advance<T>(block, block.start, block.size, frames);
+    const size_t channels = chain.getChannels();
+    std::copy_n(frames, block.size * channels, out);
+    return channels > 1;
+}
+
+template bool Oversample::render(const Block&, double*);
+template bool Oversample::render(const Block&, float*);
+
+void OversampleInput::setFactor(uint32_t newFactor)
+{
+    newFactor = validFactor(newFactor);
+    if(newFactor == factor)
+        return;
+    factor = newFactor;
+    offset = HalfBandChain(HalfBandChain::Direction::Down, factor).getLatency();
+    blocks.first = samples.first = INT64_MIN;
+}
+
+void OversampleInput::Stream::restart(uint32_t factor, int64_t sample)
+{
+    if(chain.getFactor() != factor)
+        chain = HalfBandChain(HalfBandChain::Direction::Up, factor);
+    chain.reset(1);
+    frames.clear();
+    next = sample - HalfBandChain::cPreRoll;
+    first = next * factor;
+}
+
+void OversampleInput::Stream::widen(size_t channels)
+{
+    const size_t count = available();
+    chain.widen(channels);
+    frames.resize(count * channels);
+    spreadFrames(frames.data(), count, channels);
+}
+
+void OversampleInput::Stream::append(const double* in, size_t count)
+{
+    const size_t size = frames.size();
+    frames.resize(size + count * chain.getFactor() * chain.getChannels());
+    chain.process(in, count, frames.data() + size);
+    next += static_cast<int64_t>(count);
+}
+
+void OversampleInput::Stream::consume(int64_t frame)
+{
+    const int64_t drop = std::clamp<int64_t>(frame - first, 0, static_cast<int64_t>(available()));
+    frames.erase(frames.begin(), frames.begin() + drop * chain.getChannels());
+    first += drop;
+}
+
+void OversampleInput::saveState(StateBuffer& state) const
+{
+    state.write(blocks.first);
+    state.write(blocks.next);
+    state.write(blocks.frames);
+    blocks.chain.saveState(state);
+}
+
+void OversampleInput::loadState(StateBuffer& state)
+{
+    state.read(blocks.first);
+    state.read(blocks.next);
+    state.read(blocks.frames);
+    if(blocks.chain.getFactor() != factor)
+        blocks.chain = HalfBandChain(HalfBandChain::Direction::Up, factor);
+    blocks.chain.loadState(state);
+}
+
+double OversampleInput::get(double x)
+{
+    const int64_t frame = static_cast<int64_t>(std::floor(x)) - offset;
+    if(frame != samples.first || samples.chain.getFactor() != factor)
+        samples.restart(factor, floorDiv(frame, factor));
+    while(samples.end() <= frame)
+    {
+        const double in = samples.next < 0 ? 0.0 : (*input)->get(static_cast<double>(samples.next));
+        samples.append(&in, 1);
+    }
+    samples.consume(frame);
+    const double out = samples.frames.front();
+    samples.consume(frame + 1);
+    return out;
+}
+
+template<class T>
+bool OversampleInput::render(const Block& block, T* out)
+{
+    if(block.stride != 1)
+        return SignalBase::process(block, out);
+
+    const int64_t begin = block.start - offset;
+    const int64_t end = begin + block.size;
+    const size_t width = blocks.chain.getChannels();
+    if(begin != blocks.first || blocks.chain.getFactor() != factor || (width != 1 && width != block.lanes))
+        blocks.restart(factor, floorDiv(begin, factor));
+
+    while(blocks.end() < end)
+    {
+        // The owner's block when it comes next, anything else is read outside the memos
+        Block base = block;
+        if(source && source->index == block.index && source->start == blocks.next && source->start >= 0 && source->lanes == block.lanes)
+            base.size = source->size;
+        else
+        {
+            const int64_t missing = (end - blocks.end() + factor - 1) / factor;
+            int64_t size = std::min<int64_t>(missing, Block::cMaxSize);
+            if(source && source->start > blocks.next)
+                size = std::min(size, source->start - blocks.next);
+            base.index = 0;
+            base.size = static_cast<uint32_t>(size);
+        }
+        base.start = blocks.next;
+
+        const size_t silent = silentPrefix(base);
+        BasicLanes<T> in;
+        if(silent < base.size)
+        {
+            Block heard = base;
+            heard.start += static_cast<int64_t>(silent);
+            heard.size -= static_cast<uint32_t>(silent);
+            in = pull<T>(input, heard);
+        }
+        if(in.varying && blocks.chain.getChannels() == 1 && block.lanes > 1)
+            blocks.widen(block.lanes);
+        const size_t channels = blocks.chain.getChannels();
+        double* wide = blockBuffer<double>(0, size_t(base.size) * channels);
+        std::fill_n(wide, silent * channels, 0.0);
+        if(silent < base.size)
+            toFrames(in, base.size - silent, channels, wide + silent * channels);
+        blocks.append(wide, base.size);
+    }
+
+    blocks.consume(begin);
+    const size_t channels = blocks.chain.getChannels();
+    std::copy_n(blocks.frames.data(), block.size * channels, out);
+    blocks.consume(end);
+    return channels > 1;
+}
+
+template bool OversampleInput::render(const Block&, double*);
+template bool OversampleInput::render(const Block&, float*);
+}// namespace Signals
+}// namespace DSP
@@ -0,0 +1,191 @@
+#ifndef OVERSAMPLE_HPP
+#define OVERSAMPLE_HPP
+
+#include <vector>
+#include <memory>
+#include <optional>
+
+#include "Signals/Signals.hpp"
+#include "HalfBand.hpp"
+
+extern const uint32_t SAMPLE_RATE;
+
+namespace DSP
+{
+namespace Signals
+{
+    class OversampleInput;
+
+    /**
+     * @class Oversample
+     * @brief Runs the signals feeding it at factor times the sample rate and decimates their output back
+     *
+     * The oversampled stage is everything upstream of the input up to the OversampleInput nodes,
+     * which interpolate whatever comes from outside, and to nested Oversample nodes, which own their
+     * stage. On every restart, and after the factor, the stage or the input changed, the stage is walked
+     * and its signals get the higher rate as their time, so oscillators keep their pitch and filters their corner. Signals that leave the stage
+     * get their previous rate back. A signal read both inside and outside the stage runs at the stage's
+     * rate; Convolution kernels are not resampled.
+     *
+     * The stage is rendered ahead by the decimation delay, so what the stage generates itself lines up
+     * with the rest of the graph; inputs from outside reach it late, see OversampleInput. Like Filter, process() continues from the previous block and get() from the previous
+     * sample; anywhere else they restart after HalfBandChain::cPreRoll samples of history.
+     */
+    class Oversample : public SignalBase
+    {
+    public:
+        static constexpr uint32_t cMaxFactor = 8;
+
+        Oversample(uint32_t factor = 2) :
+            SignalBase(nullptr),
+            chain(HalfBandChain::Direction::Down, factor),
+            sampleChain(HalfBandChain::Direction::Down, factor)
+        {}
+        // The clone encloses its own stage
+        Oversample(const Oversample& other) :
+            SignalBase(nullptr),
+            input(other.input),
+            chain(other.chain),
+            sampleChain(other.sampleChain),
+            baseRate(other.baseRate),
+            outerFactors(other.outerFactors),
+            nextStart(other.nextStart)
+        {}
+        ~Oversample() override;
+
+        bool isValid() const override
+        {
+            return input && (*input) && (*input)->isValid();
+        }
+        double get(double x) override;
+        ProcessImplementation
+        SignalData& getData() override
+        {
+            return (*input)->getData();
+        }
+
+        bool isStateful() const override { return true; }
+        void saveState(StateBuffer& state) const override;
+        void loadState(StateBuffer& state) override;
+        void visitInputs(const InputVisitor& visit) const override
+        {
+            visit(input);
+        }
+        void setSampleRate(double rate) override { setStage(rate, {}); }
+        uint64_t parameterHash() const override { return getFactor(); }
+
+        void setInput(const std::shared_ptr<std::shared_ptr<SignalBase>>& newInput)
+        {
+            input = newInput;
+            staged = false;
+        }
+        const std::shared_ptr<std::shared_ptr<SignalBase>>& getInput() const { return input; }
+        uint32_t getFactor() const { return chain.getFactor(); }
+        void setFactor(uint32_t factor);
+        // Called by an enclosing Oversample: the rate at its top level and the factors of the stages down to this node
+        void setStage(double rate, std::vector<uint32_t> factors);
+    private:
+        CloneImplimentation(Oversample);
+        template<class T>
+        bool render(const Block& block, T* out);
+        // Decimates the stage's output for base samples [first, first + count) into out, with the chain's channels
+        template<class T>
+        void advance(const Block& block, int64_t first, size_t count, double* out);
+        double getFrame(int64_t sample);
+
+        // Sets the rates of the stage, see the class description
+        void enclose();
+        void release(SignalBase& signal) const;
+        double outerRate() const;
+
+        std::shared_ptr<std::shared_ptr<SignalBase>> input;
+        HalfBandChain chain;
+        HalfBandChain sampleChain;
+        double baseRate = SAMPLE_RATE;
+        std::vector<uint32_t> outerFactors;
+        std::vector<std::weak_ptr<SignalBase>> enclosed;   // retimed by the last walk
+        std::vector<OversampleInput*> entries;              // the OversampleInput nodes of the own stage
+        bool staged = false;                                // enclose() ran since the factor, the stage or the input changed
+        int64_t nextStart = INT64_MIN;
+        int64_t nextSample = INT64_MIN;
+    };
+
+    /**
+     * @class OversampleInput
+     * @brief Entry of an oversampled stage, interpolates its input up to the rate of the Oversample downstream
+     *
+     * Its factor is set by the Oversample whose stage it is in, on its own it passes the input through.
+     * The input is read in the blocks of that Oversample, so other readers of it share the block and a
+     * stateful input keeps streaming; in exchange it reaches the stage the interpolation delay late.
+     */
+    class OversampleInput : public SignalBase
+    {
+    public:
+        OversampleInput() : SignalBase(nullptr) {}
+        OversampleInput(const OversampleInput& other) :
+            SignalBase(nullptr),
+            input(other.input),
+            factor(other.factor),
+            offset(other.offset),
+            blocks(other.blocks)
+        {}
+
+        bool isValid() const override
+        {
+            return input && (*input) && (*input)->isValid();
+        }
+        double get(double x) override;
+        ProcessImplementation
+        SignalData& getData() override
+        {
+            return (*input)->getData();
+        }
+
+        bool isStateful() const override { return true; }
+        void saveState(StateBuffer& state) const override;
+        void loadState(StateBuffer& state) override;
+        void visitInputs(const InputVisitor& visit) const override
+        {
+            visit(input);
+        }
+        uint64_t parameterHash() const override { return factor; }
+
+        void setInput(const std::shared_ptr<std::shared_ptr<SignalBase>>& newInput) { input = newInput; }
+        const std::shared_ptr<std::shared_ptr<SignalBase>>& getInput() const { return input; }
+        uint32_t getFactor() const { return factor; }
+        void setFactor(uint32_t newFactor);
+        // The block the owning Oversample is rendering, at the input's rate
+        void setSource(const Block& block) { source = block; }
+    private:
+        CloneImplimentation(OversampleInput);
+        template<class T>
+        bool render(const Block& block, T* out);
+
+        // Interpolated frames from frame `first` on; frames of base sample b start at b * factor
+        struct Stream
+        {
+            HalfBandChain chain{HalfBandChain::Direction::Up, 1};
+            std::vector<double> frames;
+            int64_t first = INT64_MIN;
+            int64_t next = 0;   // next base sample to interpolate
+
+            size_t available() const { return frames.empty() ? 0 : frames.size() / chain.getChannels(); }
+            int64_t end() const { return first + static_cast<int64_t>(available()); }
+            // Restarts the chain at base sample `sample` minus HalfBandChain::cPreRoll
+            void restart(uint32_t factor, int64_t sample);
+            void widen(size_t channels);
+            void append(const double* in, size_t count);
+            // Drops the frames before `frame`
+            void consume(int64_t frame);
+        };
+
+        std::shared_ptr<std::shared_ptr<SignalBase>> input;
+        uint32_t factor = 1;
+        int64_t offset = 0;     // frame = high rate sample - offset, the decimation delay of the owner
+        std::optional<Block> source;
+        Stream blocks, samples;
+    };
+}// namespace Signals
+}// namespace DSP
+
+#endif
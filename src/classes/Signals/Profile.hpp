@@ -0,0 +1,74 @@
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+
+#include <cstdint>
+#include <chrono>
+
+namespace DSP
+{
+namespace Signals
+{
+    /**
+     * @brief Block engine counters of one signal, only filled in DSP_PROFILE builds
+     *
+     * Time is exclusive: what the signal spent in its own process(), its inputs not included,
+     * so the counters of all nodes of a graph add up to the graph time.
+     */
+    struct ProfileCounters
+    {
+        uint64_t calls = 0;
+        uint64_t samples = 0;           // sample frames, lanes are not multiplied in
+        uint64_t nanoseconds = 0;
+        uint64_t allocations = 0;       // block buffer growths
+        uint64_t fallbackSamples = 0;   // samples rendered through per-sample get() calls
+        uint64_t sharedReads = 0;       // inputs served from the output already rendered for the block
+
+        void reset() { *this = {}; }
+        double nanosecondsPerSample() const { return samples ? double(nanoseconds) / double(samples) : 0.0; }
+    };
+
+#ifdef DSP_PROFILE
+    /**
+     * @brief Times one process() call; nested scopes hand their time to the parent to subtract
+     */
+    class ProfileScope
+    {
+    public:
+        ProfileScope(ProfileCounters& counters, uint64_t samples) : counters(counters), parent(current), start(now())
+        {
+            counters.calls++;
+            counters.samples += samples;
+            current = this;
+        }
+        ~ProfileScope()
+        {
+            const uint64_t elapsed = now() - start;
+            counters.nanoseconds += elapsed - children;
+            if(parent)
+                parent->children += elapsed;
+            current = parent;
+        }
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+    private:
+        static uint64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static inline thread_local ProfileScope* current = nullptr;
+        ProfileCounters& counters;
+        ProfileScope* parent;
+        uint64_t start;
+        uint64_t children = 0;
+    };
+#define DSP_PROFILE_SCOPE(block) ::DSP::Signals::ProfileScope profileScope(profile, (block).size)
+#define DSP_PROFILE_COUNT(counter, n) (profile.counter += (n))
+#else
+#define DSP_PROFILE_SCOPE(block)
+#define DSP_PROFILE_COUNT(counter, n) ((void)0)
+#endif
+}// namespace Signals
+}// namespace DSP
+
+#endif
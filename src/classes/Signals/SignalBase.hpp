@@ -3,8 +3,24 @@
 
 #include <utility>
 #include <memory>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <tuple>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <numeric>
+#include <optional>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "Signals/SignalData/SignalData.hpp"
+#include "Signals/Block.hpp"
+#include "Signals/State.hpp"
+#include "Signals/Profile.hpp"
+#include "Signals/BufferPool/BufferPool.hpp"
 
 namespace DSP
 {
@@ -28,25 +44,429 @@ namespace DSP
             ) : 
                 data(std::make_unique<SignalData>(A, freq, phase, d))
             {};
-            SignalBase(const SignalBase& other) : data(std::make_unique<SignalData>(*(other.data))){}
+            SignalBase(const SignalBase& other) : data(std::make_unique<SignalData>(*(other.data))), pool(other.pool){}
             SignalBase(const SignalData& data) : data(std::make_unique<SignalData>(data)){}
-            SignalBase(SignalBase&& other) : data(std::move(other.data)){}
+            SignalBase(SignalBase&& other) : data(std::move(other.data)), pool(other.pool){}
             SignalBase(SignalData&& data) : data(std::make_unique<SignalData>(std::move(data))){}
             virtual ~SignalBase(){}
             virtual bool isValid() const { return true; };
             virtual bool isComplex() const { return false; }
             virtual double get(double x) = 0;
 
+            /**
+             * @brief Renders a whole block at once; the default falls back to get() and is uniform across lanes
+             * @return true when out holds a separate value per lane, false when it holds one value per sample
+             */
+            virtual bool process(const Block& block, double* out)
+            {
+                DSP_PROFILE_SCOPE(block);
+                DSP_PROFILE_COUNT(fallbackSamples, block.size);
+                for(size_t i = 0; i < block.size; ++i)
+                    out[i] = get(block.x(i));
+                return false;
+            }
+            /**
+             * @brief Single precision variant of process(); the default narrows the double result
+             */
+            virtual bool process(const Block& block, float* out)
+            {
+                double* wide = grow<double>(wideBuffer, size_t(block.size) * block.lanes);
+                const bool varying = process(block, wide);
+                std::copy_n(wide, block.count(varying), out);
+                return varying;
+            }
+
+            /**
+             * @brief Stateful signals carry history from one process() call to the next.
+             * Their state is saved and restored at block boundaries so a render can seek.
+             */
+            virtual bool isStateful() const { return false; }
+            virtual void saveState(StateBuffer&) const {}
+            virtual void loadState(StateBuffer&) {}
+
+            using InputVisitor = std::function<void(const std::shared_ptr<std::shared_ptr<SignalBase>>&)>;
+            virtual void visitInputs(const InputVisitor& visit) const
+            {
+                if(!data)
+                    return;
+                for(auto* slot : {&data->amplitude, &data->freq, &data->time, &data->phase, &data->d})
+                    visit(*slot);
+            }
+
+            /**
+             * @brief Exact period of the output in samples, with a fingerprint of everything the output depends on
+             *
+             * A change of the fingerprint (a Constant edited, an input rewired) invalidates a cached period.
+             * @return nullopt when the output isn't periodic or its period isn't known to be an integer
+             */
+            struct Periodicity
+            {
+                uint64_t samples = 1;
+                uint64_t fingerprint = 0;
+            };
+            static constexpr uint64_t cMaxPeriod = 1 << 16;
+            virtual std::optional<Periodicity> periodicity() const { return std::nullopt; }
+            // Everything besides the type and the inputs that decides the output, see RenderCache::Hash()
+            virtual uint64_t parameterHash() const { return data ? data->controlRate : 0; }
+            // Samples per unit of x; the signals feeding an Oversample run at a multiple of SAMPLE_RATE. Sets the time input
+            virtual void setSampleRate(double rate);
+
+            /**
+             * @brief Renders this signal into its own buffer once per block, later calls read that buffer
+             *
+             * A node that fans out to several inputs is processed once per block instead of once
+             * per consumer. The key is the block itself (index, start, size, lanes, stride); blocks
+             * with index 0 are never memoized and render into buffers of their own, so evaluating one
+             * can't overwrite a memo another consumer is still reading. Audio and control rate blocks
+             * are kept apart as well, so the view stays valid until the signal is evaluated for another
+             * block of the same rate and kind.
+             * Periodic signals are copied out of their cached period instead, see periodicity().
+             */
+            template<class T>
+            BasicLanes<T> evaluate(const Block& block)
+            {
+                // Blocks rendering a cached period get their own memos, the ones of the current block may still be read
+                auto& memo = std::get<std::array<BlockMemo<T>, cMemoSlots>>(memos)[memoSlot(block)];
+                if(block.index != 0 && memo.matches(block))
+                {
+                    DSP_PROFILE_COUNT(sharedReads, 1);
+                    return {memo.output.template data<T>(), memo.varying};
+                }
+                T* output = grow<T>(memo.output, size_t(block.size) * block.lanes);
+                if(auto looped = loopPeriod(block, output))
+                    memo.varying = *looped;
+                else
+                    memo.varying = process(block, output);
+                memo.index = block.index;
+                memo.start = block.start;
+                memo.size = block.size;
+                memo.lanes = block.lanes;
+                memo.stride = block.stride;
+                return {output, memo.varying};
+            }
+
+            /**
+             * @brief The output evaluate() keeps for block, as the signal's consumers read it
+             * @return nullopt when the signal wasn't evaluated for block or has been evaluated for another one since
+             */
+            template<class T>
+            std::optional<BasicLanes<T>> memoized(const Block& block) const
+            {
+                auto& memo = std::get<std::array<BlockMemo<T>, cMemoSlots>>(memos)[memoSlot(block)];
+                if(block.index == 0 || !memo.matches(block))
+                    return std::nullopt;
+                return BasicLanes<T>{memo.output.template data<T>(), memo.varying};
+            }
 
             auto clone() const { return std::unique_ptr<SignalBase>(cloneImpl()); }
+
+            /**
+             * @brief Records for signal and everything upstream of it whether a stateful signal feeds it
+             *
+             * pullInput() and getInput() keep those inputs at audio rate. Call after the graph changed,
+             * a signal that was never marked counts as stateful. marks holds the signals already walked
+             * and can be shared between several roots.
+             */
+            using StatefulMarks = std::unordered_map<const SignalBase*, bool>;
+            static bool MarkStateful(SignalBase& signal, StatefulMarks& marks)
+            {
+                if(auto marked = marks.find(&signal); marked != marks.end())
+                    return marked->second;
+                marks[&signal] = false;
+                bool found = signal.isStateful();
+                signal.visitInputs([&found, &marks](const std::shared_ptr<std::shared_ptr<SignalBase>>& input) {
+                    if(input && *input && MarkStateful(**input, marks))
+                        found = true;
+                });
+                signal.statefulUpstream = found;
+                marks[&signal] = found;
+                return found;
+            }
+
+            /**
+             * @brief Whether signal and every signal upstream of it can render: each one's isValid() holds
+             * and every input it visits is connected
+             *
+             * isValid() of a signal only checks the inputs it can't do without, oscillators none of them.
+             * Walks the graph iteratively, so a long chain from an untrusted file can't exhaust the stack.
+             */
+            static bool IsValidGraph(const SignalBase& signal)
+            {
+                std::unordered_set<const SignalBase*> visited{&signal};
+                std::vector<const SignalBase*> pending{&signal};
+                bool valid = true;
+                while(valid && !pending.empty())
+                {
+                    const SignalBase* current = pending.back();
+                    pending.pop_back();
+                    valid = current->isValid();
+                    current->visitInputs([&valid, &visited, &pending](const std::shared_ptr<std::shared_ptr<SignalBase>>& input) {
+                        if(!input || !*input)
+                            valid = false;
+                        else if(visited.insert(input->get()).second)
+                            pending.push_back(input->get());
+                    });
+                }
+                return valid;
+            }
+
+            // Where the signal's buffers come from; switching pools drops the buffers held so far
+            void setPool(std::shared_ptr<BufferPool> newPool)
+            {
+                if(newPool == pool)
+                    return;
+                blockBuffers = {};
+                wideBuffer.reset();
+                memos = {};
+                periodCaches = {};
+                pool = std::move(newPool);
+            }
+            const std::shared_ptr<BufferPool>& getPool() const { return pool; }
             
             virtual SignalData& getData() { return *data; };
+
+            // Null unless the engine is built with DSP_PROFILE
+#ifdef DSP_PROFILE
+            ProfileCounters* getProfile() { return &profile; }
+#else
+            ProfileCounters* getProfile() { return nullptr; }
+#endif
         protected:
             //crutch to create signal without SignalData
             SignalBase(int* Null){}
             virtual SignalBase* cloneImpl() const = 0;
+
+            template<class T = double>
+            T* blockBuffer(size_t index, size_t count)
+            {
+                auto& buffers = blockBuffers[std::is_same_v<T, float>];
+                if(buffers.size() <= index)
+                    buffers.resize(index + 1);
+                return grow<T>(buffers[index], count);
+            }
+            // Room for count values in a buffer of this signal's pool
+            template<class T>
+            T* grow(BufferPool::Buffer& buffer, size_t count)
+            {
+                if(buffer.capacity<T>() < count)
+                    DSP_PROFILE_COUNT(allocations, 1);
+                return pool->ensure<T>(buffer, count);
+            }
+            static int64_t floorDiv(int64_t a, int64_t b) { return a / b - (a % b < 0); }
+            // Output of an input for this block, shared with every other consumer of the same input
+            template<class T = double>
+            BasicLanes<T> pull(const std::shared_ptr<std::shared_ptr<SignalBase>>& input, const Block& block)
+            {
+                return (*input)->evaluate<T>(block);
+            }
+
+            /**
+             * @brief One of the signal's own inputs, at audio rate or, when selected, at control rate:
+             * evaluated on every cControlInterval-th sample and linearly interpolated in between
+             *
+             * The grid is aligned to absolute sample positions, so the result doesn't depend on how a
+             * render is split into blocks. Inputs with a stateful signal upstream stay at audio rate,
+             * their state can't skip samples.
+             */
+            template<class T = double>
+            BasicLanes<T> pullInput(SignalData::Input input, const Block& block)
+            {
+                constexpr int64_t n = Block::cControlInterval;
+                auto& slot = data->input(input);
+                if(!data->isControlRate(input) || block.stride >= n || hasState(slot))
+                    return pull<T>(slot, block);
+
+                const int64_t first = floorDiv(block.start, n);
+                const int64_t last = floorDiv(block.start + int64_t(block.size - 1) * block.stride + n - 1, n);
+                Block grid = block;
+                grid.start = first * n;
+                grid.size = static_cast<uint32_t>(last - first + 1);
+                grid.stride = static_cast<uint32_t>(n);
+                auto points = pull<T>(slot, grid);
+                if(grid.size == 1)
+                    return points;
+
+                const size_t width = points.varying ? block.lanes : 1;
+                T* out = blockBuffer<T>(cControlBuffer + std::countr_zero(unsigned(input)), block.size * width);
+                for(size_t i = 0; i < block.size; ++i)
+                {
+                    const int64_t position = int64_t(i * block.stride) + block.start - grid.start;
+                    const int64_t k = std::min<int64_t>(position / n, grid.size - 2);
+                    const T frac = T(position - k * n) / T(n);
+                    const T* a = points.data + k * width;
+                    const T* b = a + width;
+                    for(size_t lane = 0; lane < width; ++lane)
+                        out[i * width + lane] = a[lane] + (b[lane] - a[lane]) * frac;
+                }
+                return {out, points.varying};
+            }
+            // Per-sample counterpart of pullInput()
+            double getInput(SignalData::Input input, double x)
+            {
+                constexpr double n = Block::cControlInterval;
+                auto& slot = data->input(input);
+                if(!data->isControlRate(input) || hasState(slot))
+                    return (*slot)->get(x);
+                const double grid = std::floor(x / n) * n;
+                const double a = (*slot)->get(grid);
+                if(x == grid)
+                    return a;
+                return a + ((*slot)->get(grid + n) - a) * ((x - grid) / n);
+            }
+            static std::optional<Periodicity> periodOf(const std::shared_ptr<std::shared_ptr<SignalBase>>& slot)
+            {
+                return slot && *slot ? (*slot)->blockPeriodicity() : std::nullopt;
+            }
+            // Period of a signal made of both: the least common multiple, nullopt above cMaxPeriod
+            static std::optional<Periodicity> combinePeriods(std::optional<Periodicity> a, std::optional<Periodicity> b)
+            {
+                if(!a || !b)
+                    return std::nullopt;
+                const uint64_t samples = std::lcm(a->samples, b->samples);
+                if(samples > cMaxPeriod)
+                    return std::nullopt;
+                return Periodicity{samples, mixFingerprint(a->fingerprint, b->fingerprint)};
+            }
+            static uint64_t mixFingerprint(uint64_t seed, uint64_t value)
+            {
+                return seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+            }
+            // Identity of the signal object and its dynamic type, the base of every fingerprint
+            uint64_t selfFingerprint() const
+            {
+                return mixFingerprint(reinterpret_cast<uintptr_t>(this), reinterpret_cast<uintptr_t>(typeid(*this).name()));
+            }
+            // The input is stateful or has a stateful signal upstream, as of the last MarkStateful()
+            static bool hasState(const std::shared_ptr<std::shared_ptr<SignalBase>>& slot)
+            {
+                return slot && *slot && (*slot)->statefulUpstream;
+            }
             
             std::unique_ptr<SignalData> data;
+            // Ahead of every buffer, they give their memory back to it when destroyed
+            std::shared_ptr<BufferPool> pool = BufferPool::Default();
+            std::array<std::vector<BufferPool::Buffer>, 2> blockBuffers;    // double, float
+            BufferPool::Buffer wideBuffer;
+            bool statefulUpstream = true;
+#ifdef DSP_PROFILE
+            ProfileCounters profile;
+#endif
+        private:
+            static constexpr size_t cControlBuffer = 8;     // first blockBuffer of the interpolated control inputs
+            static constexpr uint64_t cMaxPeriodValues = 1 << 17;  // period cache limit, samples times lanes
+
+            template<class T>
+            struct PeriodCache
+            {
+                uint64_t samples = 0;
+                uint64_t fingerprint = 0;
+                uint32_t lanes = 0;
+                Accuracy accuracy = Accuracy::Exact;
+                bool varying = false;
+                BufferPool::Buffer values;
+            };
+
+            /**
+             * @brief Copies the block out of the cached period when the signal is periodic, rendering that
+             * period first if the cache is missing or stale
+             * @return nullopt when the block has to be processed normally
+             */
+            template<class T>
+            std::optional<bool> loopPeriod(const Block& block, T* out)
+            {
+                if(!block.loopPeriods || block.stride != 1)
+                    return std::nullopt;
+                periodWalk = block.index;
+                auto period = blockPeriodicity();
+                periodWalk = 0;
+                // Period 1 is a constant, already as cheap as a copy
+                if(!period || period->samples <= 1 || period->samples * block.lanes > cMaxPeriodValues)
+                    return std::nullopt;
+
+                auto& cache = std::get<PeriodCache<T>>(periodCaches);
+                const uint64_t samples = period->samples;
+                if(cache.samples != samples || cache.fingerprint != period->fingerprint || cache.lanes != block.lanes || cache.accuracy != block.accuracy)
+                {
+                    // One period from x = 0, with nested caches off so the subgraph isn't cached twice
+                    const size_t lanes = block.lanes;
+                    T* values = grow<T>(cache.values, samples * lanes);
+                    std::vector<bool> parts;
+                    Block part{0, 0, block.lanes, 0, block.accuracy, 1, false};
+                    for(uint64_t start = 0; start < samples; start += Block::cMaxSize)
+                    {
+                        part.start = static_cast<int64_t>(start);
+                        part.size = static_cast<uint32_t>(std::min<uint64_t>(Block::cMaxSize, samples - start));
+                        T* dst = values + start * lanes;
+                        const bool varying = process(part, dst);
+                        parts.push_back(varying);
+                        // Uniform parts are spread to every lane, backwards so nothing is overwritten before it is read
+                        for(size_t i = varying ? 0 : part.size; i-- > 0;)
+                            std::fill_n(dst + i * lanes, lanes, dst[i]);
+                    }
+                    cache.varying = std::find(parts.begin(), parts.end(), true) != parts.end();
+                    if(!cache.varying)
+                    {
+                        for(uint64_t i = 0; i < samples; ++i)
+                            values[i] = values[i * lanes];
+                    }
+                    cache.samples = samples;
+                    cache.fingerprint = period->fingerprint;
+                    cache.lanes = block.lanes;
+                    cache.accuracy = block.accuracy;
+                }
+
+                const size_t width = cache.varying ? block.lanes : 1;
+                uint64_t position = static_cast<uint64_t>(block.start % static_cast<int64_t>(samples) + static_cast<int64_t>(samples)) % samples;
+                for(size_t done = 0; done < block.size;)
+                {
+                    const size_t run = std::min<uint64_t>(block.size - done, samples - position);
+                    std::copy_n(cache.values.template data<T>() + position * width, run * width, out + done * width);
+                    done += run;
+                    position = 0;
+                }
+                return cache.varying;
+            }
+
+            // periodicity(), asked once per block while a block is looked up, every time otherwise
+            std::optional<Periodicity> blockPeriodicity()
+            {
+                if(periodWalk == 0)
+                    return periodicity();
+                if(periodBlock != periodWalk)
+                {
+                    blockPeriod = periodicity();
+                    periodBlock = periodWalk;
+                }
+                return blockPeriod;
+            }
+
+            template<class T>
+            struct BlockMemo
+            {
+                uint64_t index = 0;
+                int64_t start = 0;
+                uint32_t size = 0;
+                uint32_t lanes = 0;
+                uint32_t stride = 0;
+                bool varying = false;
+                BufferPool::Buffer output;
+
+                bool matches(const Block& block) const
+                {
+                    return index == block.index && start == block.start && size == block.size && lanes == block.lanes && stride == block.stride;
+                }
+            };
+            // By rate, period loop and whether the block is memoized at all, see evaluate()
+            static constexpr size_t cMemoSlots = 8;
+            static size_t memoSlot(const Block& block)
+            {
+                return (block.stride != 1) + (block.loopPeriods ? 0 : 2) + (block.index == 0 ? 4 : 0);
+            }
+            std::tuple<std::array<BlockMemo<double>, cMemoSlots>, std::array<BlockMemo<float>, cMemoSlots>> memos;
+            std::tuple<PeriodCache<double>, PeriodCache<float>> periodCaches;
+            static inline thread_local uint64_t periodWalk = 0;    // index of the block whose periods are being looked up
+            uint64_t periodBlock = 0;
+            std::optional<Periodicity> blockPeriod;
         };
 
     }
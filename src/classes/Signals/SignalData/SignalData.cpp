@@ -22,7 +22,8 @@ namespace DSP
             freq(other.freq),
             time(other.time),
             phase(other.phase),
-            d(other.d)
+            d(other.d),
+            controlRate(other.controlRate)
         {
         }
         SignalData::SignalData(SignalData &&other) :
@@ -30,8 +31,20 @@ namespace DSP
             freq(std::move(other.freq)),
             time(std::move(other.time)),
             phase(std::move(other.phase)),
-            d(std::move(other.d))
+            d(std::move(other.d)),
+            controlRate(other.controlRate)
         {
         }
+
+        std::shared_ptr<std::shared_ptr<SignalBase>>& SignalData::input(Input input)
+        {
+            switch(input)
+            {
+                case Amplitude: return amplitude;
+                case Frequency: return freq;
+                case Phase: return phase;
+                default: return d;
+            }
+        }
     }
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define SIGNALDATA_HPP
 
 #include <memory>
+#include <cstdint>
 
 namespace DSP
 {
@@ -11,15 +12,29 @@ namespace DSP
 
         struct SignalData
         {
+            // Inputs that can run at control rate, as bits of controlRate
+            enum Input : uint8_t
+            {
+                Amplitude = 1 << 0,
+                Frequency = 1 << 1,
+                Phase = 1 << 2,
+                Duty = 1 << 3
+            };
+
             SignalData(double A = 0.5, double freq = 440.0, double phase = 0.0, double d = 0.5);
             SignalData(const SignalData& other);
             SignalData(SignalData&& other);
 
+            std::shared_ptr<std::shared_ptr<SignalBase>>& input(Input input);
+            bool isControlRate(Input input) const { return controlRate & input; }
+            void setControlRate(Input input, bool enabled) { controlRate = enabled ? (controlRate | input) : (controlRate & ~input); }
+
             std::shared_ptr<std::shared_ptr<SignalBase>> amplitude;
             std::shared_ptr<std::shared_ptr<SignalBase>> freq;
             std::shared_ptr<std::shared_ptr<SignalBase>> time;
             std::shared_ptr<std::shared_ptr<SignalBase>> phase;
             std::shared_ptr<std::shared_ptr<SignalBase>> d;
+            uint8_t controlRate = 0;
         };
     }
 }
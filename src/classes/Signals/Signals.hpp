@@ -6,87 +6,281 @@
 #include <random>
 #include <memory>
 #include <functional>
+#include <algorithm>
+#include <vector>
+#include <bit>
+#include <numeric>
+#include <optional>
+#include <utility>
 
 #include "SignalBase.hpp"
 
 constexpr static double pi2 = 2 * M_PI;
 extern const uint32_t SAMPLE_RATE;
 
-#define ConstructorsInit(className) (className)(double A = 0.5, double freq = 440.0, double phase = 0.0, double d = 0.5) : SignalBase(A, freq, phase, d){}\
-                                    (className)(const SignalBase& other) : SignalBase(other){}\
-                                    (className)(const SignalData& data) : SignalBase(data){}\
-                                    (className)(SignalBase&& other) : SignalBase(std::move(other)){}\
-                                    (className)(SignalData&& data) : SignalBase(std::move(data)){}
+#define ConstructorsInit(className, baseName) (className)(double A = 0.5, double freq = 440.0, double phase = 0.0, double d = 0.5) : baseName(A, freq, phase, d){}\
+                                    (className)(const SignalBase& other) : baseName(other){}\
+                                    (className)(const SignalData& data) : baseName(data){}\
+                                    (className)(SignalBase&& other) : baseName(std::move(other)){}\
+                                    (className)(SignalData&& data) : baseName(std::move(data)){}
 
 #define CloneImplimentation(className) virtual className* cloneImpl() const override { return new className(*this); }
 
+// Both process() precisions forwarding to a `template<class T> bool render(const Block&, T*)`
+#define ProcessImplementation bool process(const Block& block, double* out) override { DSP_PROFILE_SCOPE(block); return render(block, out); }\
+                              bool process(const Block& block, float* out) override { DSP_PROFILE_SCOPE(block); return render(block, out); }
+
 namespace DSP
 {
     class ConstantNode;
 namespace Signals
 {
 
-    class Sin : public SignalBase
+    /**
+     * @class Oscillator
+     * @brief Signal of the form amplitude * shape(pi2 * freq * x / time + phase, d)
+     *
+     * The cycles freq * x / time are wrapped to [0, 1) before they are scaled, on a 64-bit fixed
+     * point Phase: the product with the integer sample clock wraps around exactly, so the phase
+     * is as precise after hours as in the first second. Blocks carry it forward as an accumulator
+     * per lane while freq / time holds. In single precision the argument is also reduced modulo pi2
+     * before the shape is evaluated in float.
+     */
+    class Oscillator : public SignalBase
+    {
+    public:
+        ConstructorsInit(Oscillator, SignalBase);
+        virtual double shape(double arg, double d) const = 0;
+        // Periodic with constant frequency and time, the other inputs periodic as well
+        std::optional<Periodicity> periodicity() const override;
+
+        // Fraction of a cycle, 2^64 is one whole cycle; unsigned wrap-around is the modulo
+        using Phase = uint64_t;
+        // freq / time cycles per sample as a Phase step, the whole cycles dropped
+        static Phase phaseStep(double freq, double time)
+        {
+            const double cycles = freq / time;
+            if(!std::isfinite(cycles))
+                return 0;
+            // Above -2^-53 the wrapped cycles round up to a whole one, 2^64; the step is a few units then, taken directly
+            const double fraction = cycles - std::floor(cycles);
+            Phase step = fraction < 1.0 ? static_cast<Phase>(std::ldexp(fraction, 64)) : static_cast<Phase>(std::llround(std::ldexp(cycles, 64)));
+            // The rounding error of the division, recovered exactly by fma, fills in the bits below the double's last one.
+            // It is a few units of 2^-64 unless the division underflowed, which is left alone
+            if(std::abs(cycles) < 1.0)
+            {
+                const double error = std::ldexp(std::fma(-cycles, time, freq) / time, 64);
+                if(std::abs(error) < 0x1p62)
+                    step += static_cast<Phase>(std::llround(error));
+            }
+            return step;
+        }
+        static Phase phaseAt(Phase step, int64_t sample) { return step * static_cast<Phase>(sample); }
+        static double phaseCycles(Phase phase) { return static_cast<double>(phase >> 11) * 0x1p-53; }
+        // pi2 * freq * x / time + phase with the cycles wrapped first; x between samples takes the plain product
+        static double phaseArgument(double freq, double time, double x, double phase)
+        {
+            if(x != std::trunc(x) || std::abs(x) >= 0x1p63)
+                return pi2 * freq * x / time + phase;
+            return pi2 * phaseCycles(phaseAt(phaseStep(freq, time), static_cast<int64_t>(x))) + phase;
+        }
+    protected:
+        double argument(double x)
+        {
+            return phaseArgument(getInput(SignalData::Frequency, x), (*data->time)->get(x), x, getInput(SignalData::Phase, x));
+        }
+
+        template<class T>
+        static T shapeArgument(double arg)
+        {
+            if constexpr(std::is_same_v<T, double>)
+                return arg;
+            else
+                return static_cast<T>(arg - pi2 * FastMath::trunc(arg / pi2));    // fmod semantics, without its cost
+        }
+
+        template<class Shape, bool UsesDuty = false, class T>
+        bool processShape(const Block& block, T* out)
+        {
+            switch(block.accuracy)
+            {
+            case Accuracy::High: return processShapeAt<Shape, UsesDuty, Accuracy::High>(block, out);
+            case Accuracy::Fast: return processShapeAt<Shape, UsesDuty, Accuracy::Fast>(block, out);
+            default: return processShapeAt<Shape, UsesDuty, Accuracy::Exact>(block, out);
+            }
+        }
+    private:
+        // Relative error of a whole number of cycles still counted as exact, the phase drifts by at most this per period
+        static constexpr double cPeriodTolerance = 1e-12;
+
+        /**
+         * @brief Fewest samples holding a whole number of cycles at `cycles` per sample
+         *
+         * Walks the convergents of the continued fraction of `cycles`, the best rational
+         * approximations in order of their denominator, so the first one that is exact is the period.
+         */
+        static std::optional<uint64_t> cyclePeriod(double cycles)
+        {
+            cycles = std::abs(cycles);
+            if(!std::isfinite(cycles))
+                return std::nullopt;
+            double fraction = cycles - std::floor(cycles);
+            uint64_t previous = 0;
+            uint64_t samples = 1;
+            while(samples <= cMaxPeriod)
+            {
+                const double turns = cycles * double(samples);
+                if(std::abs(turns - std::round(turns)) <= cPeriodTolerance * std::max(1.0, turns))
+                    return samples;
+                const double term = std::floor(1.0 / fraction);
+                if(term > double(cMaxPeriod))
+                    break;
+                fraction = 1.0 / fraction - term;
+                previous = std::exchange(samples, uint64_t(term) * samples + previous);
+            }
+            return std::nullopt;
+        }
+
+        template<class Shape, bool UsesDuty, Accuracy A, class T>
+        bool processShapeAt(const Block& block, T* out)
+        {
+            auto freq = pullInput<T>(SignalData::Frequency, block);
+            auto time = pull<T>(data->time, block);
+            auto cycles = wrappedCycles(block, freq, time);
+            auto phase = pullInput<T>(SignalData::Phase, block);
+            T* wave = blockBuffer<T>(3, size_t(block.size) * block.lanes);
+            bool varying;
+            if constexpr(UsesDuty)
+            {
+                auto d = pullInput<T>(SignalData::Duty, block);
+                varying = mapLanes(block, wave, [](double, double c, double p, T d) {
+                    return Shape::template wave<T, A>(shapeArgument<T>(pi2 * c + p), d);
+                }, cycles, phase, d);
+            }
+            else
+            {
+                varying = mapLanes(block, wave, [](double, double c, double p) {
+                    return Shape::template wave<T, A>(shapeArgument<T>(pi2 * c + p), T(0));
+                }, cycles, phase);
+            }
+            // Amplitude last, so a swept amplitude reuses the shared waveform
+            auto amplitude = pullInput<T>(SignalData::Amplitude, block);
+            return mapLanes(block, out, [](double, T a, T w) { return a * w; }, amplitude, BasicLanes<T>{wave, varying});
+        }
+
+        // Wrapped cycles of every sample: an accumulator per lane, restarted from the clock whenever freq / time changes
+        template<class T>
+        Lanes wrappedCycles(const Block& block, const BasicLanes<T>& freq, const BasicLanes<T>& time)
+        {
+            const bool varying = freq.varying || time.varying;
+            const size_t width = varying ? block.lanes : 1;
+            double* cycles = blockBuffer<double>(4, size_t(block.size) * width);
+            for(size_t lane = 0; lane < width; ++lane)
+            {
+                double lastFreq = NAN, lastTime = NAN;
+                Phase phase = 0, step = 0;
+                for(size_t i = 0; i < block.size; ++i)
+                {
+                    const double f = freq(i, lane, width);
+                    const double t = time(i, lane, width);
+                    if(f != lastFreq || t != lastTime)
+                    {
+                        lastFreq = f;
+                        lastTime = t;
+                        step = phaseStep(f, t);
+                        phase = phaseAt(step, block.sample(i));
+                        step *= block.stride;
+                    }
+                    else
+                        phase += step;
+                    cycles[i * width + lane] = phaseCycles(phase);
+                }
+            }
+            return {cycles, varying};
+        }
+    };
+
+    class Sin : public Oscillator
     {
     public:
-        ConstructorsInit(Sin);
+        ConstructorsInit(Sin, Oscillator);
         double get(double x) override
         {
-            double res = (*data->amplitude)->get(x) * ::sin(pi2 * (*data->freq)->get(x) * x / (*data->time)->get(x) + (*data->phase)->get(x)); 
+            double res = getInput(SignalData::Amplitude, x) * ::sin(argument(x)); 
             return res;
         }
+        template<class T, Accuracy A = Accuracy::Exact> static T wave(T arg, T) { return FastMath::sin<A>(arg); }
+        double shape(double arg, double d) const override { return wave(arg, d); }
+        ProcessImplementation
+        template<class T> bool render(const Block& block, T* out) { return processShape<Sin>(block, out); }
     private:
         CloneImplimentation(Sin);
     };
 
-    class Cos : public SignalBase
+    class Cos : public Oscillator
     {
     public:
-        ConstructorsInit(Cos);
+        ConstructorsInit(Cos, Oscillator);
         double get(double x) override
         {
-            double res = (*data->amplitude)->get(x) * ::cos(pi2 * (*data->freq)->get(x) * x / (*data->time)->get(x) + (*data->phase)->get(x)); 
+            double res = getInput(SignalData::Amplitude, x) * ::cos(argument(x)); 
             return res;
         }
+        template<class T, Accuracy A = Accuracy::Exact> static T wave(T arg, T) { return FastMath::cos<A>(arg); }
+        double shape(double arg, double d) const override { return wave(arg, d); }
+        ProcessImplementation
+        template<class T> bool render(const Block& block, T* out) { return processShape<Cos>(block, out); }
     private:
         CloneImplimentation(Cos);
     };
 
-    class Triangle : public SignalBase
+    class Triangle : public Oscillator
     {
     public:
-        ConstructorsInit(Triangle);
+        ConstructorsInit(Triangle, Oscillator);
         double get(double x) override
         {
-            double res = (*data->amplitude)->get(x) * M_2_PI *(std::abs(fmod(pi2 * (*data->freq)->get(x) * x / (*data->time)->get(x) + (*data->phase)->get(x) + 3 * M_PI_2, pi2) - M_PI) - M_PI_2);
+            double res = getInput(SignalData::Amplitude, x) * M_2_PI *(std::abs(fmod(argument(x) + 3 * M_PI_2, pi2) - M_PI) - M_PI_2);
             return res;
         }
+        template<class T, Accuracy A = Accuracy::Exact> static T wave(T arg, T) { return T(M_2_PI) * (std::abs(FastMath::fmod<A>(arg + T(3 * M_PI_2), T(pi2)) - T(M_PI)) - T(M_PI_2)); }
+        double shape(double arg, double d) const override { return wave(arg, d); }
+        ProcessImplementation
+        template<class T> bool render(const Block& block, T* out) { return processShape<Triangle>(block, out); }
     private:
         CloneImplimentation(Triangle);
     };
 
-    class Sawtooth : public SignalBase
+    class Sawtooth : public Oscillator
     {
     public:
-        ConstructorsInit(Sawtooth)
+        ConstructorsInit(Sawtooth, Oscillator)
         double get(double x) override
         {
-            double res = (*data->amplitude)->get(x) * M_1_PI * (fmod(pi2 * (*data->freq)->get(x) * x / (*data->time)->get(x) + (*data->phase)->get(x) + M_PI, pi2) - M_PI);
+            double res = getInput(SignalData::Amplitude, x) * M_1_PI * (fmod(argument(x) + M_PI, pi2) - M_PI);
             return res;
         }
+        template<class T, Accuracy A = Accuracy::Exact> static T wave(T arg, T) { return T(M_1_PI) * (FastMath::fmod<A>(arg + T(M_PI), T(pi2)) - T(M_PI)); }
+        double shape(double arg, double d) const override { return wave(arg, d); }
+        ProcessImplementation
+        template<class T> bool render(const Block& block, T* out) { return processShape<Sawtooth>(block, out); }
     private:
         CloneImplimentation(Sawtooth);
     };
 
-    class Pulse : public SignalBase
+    class Pulse : public Oscillator
     {
     public:
-        ConstructorsInit(Pulse)
+        ConstructorsInit(Pulse, Oscillator)
          double get(double x) override
         {
-            double res = std::fmod(pi2 * (*data->freq)->get(x) * x / (*data->time)->get(x) + (*data->phase)->get(x), pi2) / pi2;
-            return res <= (*data->d)->get(x) ? (*data->amplitude)->get(x) : -(*data->amplitude)->get(x);
+            double res = std::fmod(argument(x), pi2) / pi2;
+            return res <= getInput(SignalData::Duty, x) ? getInput(SignalData::Amplitude, x) : -getInput(SignalData::Amplitude, x);
         }
+        template<class T, Accuracy A = Accuracy::Exact> static T wave(T arg, T d) { return FastMath::fmod<A>(arg, T(pi2)) / T(pi2) <= d ? T(1) : T(-1); }
+        double shape(double arg, double d) const override { return wave(arg, d); }
+        ProcessImplementation
+        template<class T> bool render(const Block& block, T* out) { return processShape<Pulse, true>(block, out); }
     private:
         CloneImplimentation(Pulse);
     };
@@ -94,14 +288,28 @@ namespace Signals
     class Noise : public SignalBase
     {
     public:
-        ConstructorsInit(Noise)
+        ConstructorsInit(Noise, SignalBase)
          double get(double x) override
         {
-            std::mt19937 gen(x + (*data->phase)->get(x)); 
-            static std::uniform_real_distribution<> dis(-1.0f, 1.0f);
-            double res = (*data->amplitude)->get(x) * dis(gen);
+            std::mt19937 gen(x + getInput(SignalData::Phase, x)); 
+            std::uniform_real_distribution<> dis(-1.0f, 1.0f);
+            double res = getInput(SignalData::Amplitude, x) * dis(gen);
             return res;
         }
+        ProcessImplementation
+        template<class T>
+        bool render(const Block& block, T* out)
+        {
+            auto phase = pullInput<T>(SignalData::Phase, block);
+            T* noise = blockBuffer<T>(1, size_t(block.size) * block.lanes);
+            bool varying = mapLanes(block, noise, [](double x, double p) {
+                std::mt19937 gen(x + p);
+                std::uniform_real_distribution<> dis(-1.0f, 1.0f);
+                return static_cast<T>(dis(gen));
+            }, phase);
+            auto amplitude = pullInput<T>(SignalData::Amplitude, block);
+            return mapLanes(block, out, [](double, T a, T n) { return a * n; }, amplitude, BasicLanes<T>{noise, varying});
+        }
     private:
         CloneImplimentation(Noise);
     };
@@ -119,16 +327,87 @@ namespace Signals
         {
             return value;
         }
+        ProcessImplementation
+        template<class T>
+        bool render(const Block& block, T* out)
+        {
+            std::fill_n(out, block.size, static_cast<T>(value));
+            return false;
+        }
         void set(double newValue)
         {
             value = newValue;
         }
+        double getValue() const { return value; }
+        uint64_t parameterHash() const override { return std::bit_cast<uint64_t>(value); }
+        std::optional<Periodicity> periodicity() const override
+        {
+            return Periodicity{1, mixFingerprint(selfFingerprint(), std::bit_cast<uint64_t>(value))};
+        }
         ~Constant() override {}
     private:
         CloneImplimentation(Constant);
         double value;
     };
 
+    inline void SignalBase::setSampleRate(double rate)
+    {
+        if(!data)
+            return;
+        // A new slot, clones share the one of the original
+        auto* time = data->time ? dynamic_cast<const Constant*>(data->time->get()) : nullptr;
+        if(!time || time->getValue() != rate)
+            data->time = std::make_shared<std::shared_ptr<SignalBase>>(std::make_shared<Constant>(rate));
+    }
+
+    /**
+     * @class LaneConstant
+     * @brief Constant with its own value in every lane, used to render parameter sweeps in one pass
+     */
+    class LaneConstant : public SignalBase
+    {
+    public:
+        LaneConstant(std::vector<double> values) : SignalBase(nullptr), values(std::move(values)) {}
+        LaneConstant(const LaneConstant& other) : SignalBase(nullptr), values(other.values) {}
+
+        double get(double) override
+        {
+            return values.front();
+        }
+        ProcessImplementation
+        template<class T>
+        bool render(const Block& block, T* out)
+        {
+            if(block.lanes != values.size())
+            {
+                std::fill_n(out, block.size, static_cast<T>(values.front()));
+                return false;
+            }
+            for(size_t i = 0; i < block.size; ++i)
+                std::copy(values.begin(), values.end(), out + i * block.lanes);
+            return true;
+        }
+        const std::vector<double>& getValues() const { return values; }
+        void set(size_t lane, double value) { values[lane] = value; }
+        std::optional<Periodicity> periodicity() const override
+        {
+            uint64_t fingerprint = selfFingerprint();
+            for(double value : values)
+                fingerprint = mixFingerprint(fingerprint, std::bit_cast<uint64_t>(value));
+            return Periodicity{1, fingerprint};
+        }
+        uint64_t parameterHash() const override
+        {
+            uint64_t hash = values.size();
+            for(double value : values)
+                hash = mixFingerprint(hash, std::bit_cast<uint64_t>(value));
+            return hash;
+        }
+    private:
+        CloneImplimentation(LaneConstant);
+        std::vector<double> values;
+    };
+
     class ComplexSignal : public SignalBase
     {
     public:
@@ -170,10 +449,23 @@ namespace Signals
         {
             return _func((*left)->get(x), (*right)->get(x));
         }
+        ProcessImplementation
+        template<class T>
+        bool render(const Block& block, T* out)
+        {
+            return processBinary(block, out, _func);
+        }
         virtual SignalData& getData() override
         {
             return (*left)->getData();
         }
+        std::optional<Periodicity> periodicity() const override
+        {
+            auto period = combinePeriods(periodOf(left), periodOf(right));
+            if(period)
+                period->fingerprint = mixFingerprint(period->fingerprint, selfFingerprint());
+            return period;
+        }
         std::shared_ptr<std::shared_ptr<SignalBase>>& getLeft()
         {
             return left;
@@ -182,6 +474,11 @@ namespace Signals
         {
             return right;
         }
+        void visitInputs(const InputVisitor& visit) const override
+        {
+            visit(left);
+            visit(right);
+        }
         void SetLeft(std::shared_ptr<std::shared_ptr<SignalBase>>& newLeft)
         {
             left = newLeft;
@@ -193,6 +490,14 @@ namespace Signals
         virtual ~ComplexSignal() override {}
     protected:
         CloneImplimentation(ComplexSignal);
+        template<class Op, class T>
+        bool processBinary(const Block& block, T* out, const Op& op)
+        {
+            auto l = pull<T>(left, block);
+            auto r = pull<T>(right, block);
+            return mapLanes(block, out, [&op](double, T a, T b) { return static_cast<T>(op(a, b)); }, l, r);
+        }
+
         std::shared_ptr<std::shared_ptr<SignalBase>> left;
         std::shared_ptr<std::shared_ptr<SignalBase>> right;
         std::function<double(double, double)> _func;
@@ -224,8 +529,10 @@ namespace Signals
             double sum = 0.0;
 
             sum = accumulatedIntegrate(x);
+            // The frequency that puts the modulated signal sum cycles in at x = SAMPLE_RATE
+            const double time = (*(*left)->getData().time)->get(SAMPLE_RATE);
             auto tempPrevFreq = (*left)->getData().freq;
-            auto temp = std::make_shared<Signals::Constant>(sum);
+            auto temp = std::make_shared<Signals::Constant>(sum * time / SAMPLE_RATE);
             auto tempPtr = std::make_shared<std::shared_ptr<Signals::SignalBase>>(temp);
             (*left)->getData().freq = tempPtr;
             result = (*left)->get(SAMPLE_RATE);
@@ -233,21 +540,105 @@ namespace Signals
             
             return result;
         }
+
+        ProcessImplementation
+        template<class T>
+        bool render(const Block& block, T* out)
+        {
+            auto* oscillator = dynamic_cast<Oscillator*>(left->get());
+            if(!oscillator)
+                return SignalBase::process(block, out);
+
+            // Same integration as accumulatedIntegrate, kept per lane and always in double
+            auto freq = pull<T>((*left)->getData().freq, block);
+            auto modulator = pull<T>(right, block);
+            auto time = pull<T>(oscillator->getData().time, block);
+            const size_t lanes = block.lanes;
+            if(lanePrev.size() != lanes)
+                lanePrev.assign(lanes, 0.0);
+            double* sum = blockBuffer(2, size_t(block.size) * lanes);
+            const bool varying = freq.varying || modulator.varying || time.varying;
+            for(size_t i = 0; i < block.size; ++i)
+            {
+                const double x = block.x(i);
+                for(size_t lane = 0; lane < (varying ? lanes : 1); ++lane)
+                {
+                    double& prev = lanePrev[lane];
+                    if(x < 1)
+                        prev = 0.0;
+                    else
+                        prev = wrapCycles(prev + double(freq(i, lane, lanes)) * (1 + double(modulator(i, lane, lanes))) / double(time(i, lane, lanes)));
+                    sum[i * (varying ? lanes : 1) + lane] = prev;
+                }
+            }
+
+            // The other inputs of the modulated signal are evaluated at x = SAMPLE_RATE, outside the memos
+            // of this block: other consumers of the same upstream nodes may still read those
+            Block atRate{SAMPLE_RATE, 1, block.lanes, 0, block.accuracy};
+            auto amplitude = pullHeld<T>(oscillator->getData().amplitude, block, atRate, 3);
+            auto phase = pullHeld<T>(oscillator->getData().phase, block, atRate, 5);
+            auto d = pullHeld<T>(oscillator->getData().d, block, atRate, 6);
+            return mapLanes(block, out, [oscillator](double, double s, double a, double p, double d) {
+                return static_cast<T>(a * oscillator->shape(pi2 * s + p, d));
+            }, Lanes{sum, varying}, amplitude, phase, d);
+        }
+
+        std::optional<Periodicity> periodicity() const override { return std::nullopt; }
+        bool isStateful() const override { return true; }
+        void saveState(StateBuffer& state) const override
+        {
+            state.write(lanePrev);
+        }
+        void loadState(StateBuffer& state) override
+        {
+            state.read(lanePrev);
+        }
+
+        // get() keeps the running sum every cSampleCheckpoint samples, so out of order access resumes from there
+        static constexpr int64_t cSampleCheckpoint = 4096;
     private:
         CloneImplimentation(freqModulator);
+        // Evaluates input at a single sample and holds that value across the block
+        template<class T>
+        BasicLanes<T> pullHeld(const std::shared_ptr<std::shared_ptr<SignalBase>>& input, const Block& block, const Block& at, size_t buffer)
+        {
+            T* held = blockBuffer<T>(buffer, size_t(block.size) * block.lanes);
+            bool varying = (*input)->process(at, held);
+            const size_t width = varying ? block.lanes : 1;
+            for(size_t i = 1; i < block.size; ++i)
+                std::copy_n(held, width, held + i * width);
+            return {held, varying};
+        }
         double accumulatedIntegrate(double x)
         {
-            static double prev = 0.0;
-            
             if(x < 1)
             {
                 prev = 0.0;
+                nextX = 1.0;
+                sampleCheckpoints.clear();
                 return prev;
             }
 
-            prev += (*((*left)->getData().freq))->get(x) * (1 + (*right)->get(x)) / SAMPLE_RATE; 
+            if(x != nextX)
+            {
+                const size_t k = std::min<size_t>(static_cast<size_t>((x - 1) / cSampleCheckpoint), sampleCheckpoints.size());
+                prev = k > 0 ? sampleCheckpoints[k - 1] : 0.0;
+                for(double t = static_cast<double>(k * cSampleCheckpoint) + 1; t < x; ++t)
+                    step(t);
+            }
+            step(x);
+            nextX = x + 1;
             return prev;
         }
+        // The running sum is kept in [0, 1) cycles, so its precision doesn't fall with the render length
+        static double wrapCycles(double cycles) { return cycles - std::floor(cycles); }
+        void step(double x)
+        {
+            prev = wrapCycles(prev + (*((*left)->getData().freq))->get(x) * (1 + (*right)->get(x)) / (*(*left)->getData().time)->get(x));
+            const auto sample = static_cast<int64_t>(x);
+            if(sample == x && sample % cSampleCheckpoint == 0 && size_t(sample / cSampleCheckpoint) == sampleCheckpoints.size() + 1)
+                sampleCheckpoints.push_back(prev);
+        }
         double integrate(double a, double b, int step)
         {
             double h = (b - a) / step; 
@@ -260,6 +651,11 @@ namespace Signals
 
             return (h / 2) * sum; 
         }
+
+        double prev = 0.0;
+        double nextX = 1.0;
+        std::vector<double> sampleCheckpoints;  // running sum through sample (k + 1) * cSampleCheckpoint
+        std::vector<double> lanePrev;
     };
 
     class SumParam : public ComplexSignal
@@ -286,6 +682,13 @@ namespace Signals
             )
         {}
         
+        ProcessImplementation
+        template<class T>
+        bool render(const Block& block, T* out)
+        {
+            return processBinary(block, out, std::plus<T>());
+        }
+        
         ~SumParam() override {}
     private:
         CloneImplimentation(SumParam);
@@ -315,11 +718,42 @@ namespace Signals
             )
         {}
 
+        ProcessImplementation
+        template<class T>
+        bool render(const Block& block, T* out)
+        {
+            return processBinary(block, out, std::multiplies<T>());
+        }
+
         ~MulParam() override {}
     private:
         CloneImplimentation(MulParam);
     };
 
+    inline std::optional<SignalBase::Periodicity> Oscillator::periodicity() const
+    {
+        auto* freq = dynamic_cast<const Constant*>(data->freq ? data->freq->get() : nullptr);
+        auto* time = dynamic_cast<const Constant*>(data->time ? data->time->get() : nullptr);
+        if(!freq || !time || time->getValue() == 0.0)
+            return std::nullopt;
+        auto samples = cyclePeriod(freq->getValue() / time->getValue());
+        if(!samples)
+            return std::nullopt;
+
+        std::optional<Periodicity> period = Periodicity{*samples, mixFingerprint(selfFingerprint(), data->controlRate)};
+        period = combinePeriods(period, freq->periodicity());
+        period = combinePeriods(period, time->periodicity());
+        for(auto input : {SignalData::Amplitude, SignalData::Phase, SignalData::Duty})
+        {
+            auto inputPeriod = periodOf(data->input(input));
+            // Interpolation between control points repeats once the points do and the grid lines up again
+            if(inputPeriod && inputPeriod->samples > 1 && data->isControlRate(input))
+                inputPeriod->samples = std::lcm<uint64_t>(inputPeriod->samples, Block::cControlInterval);
+            period = combinePeriods(period, inputPeriod);
+        }
+        return period;
+    }
+
 
 }// namespace Signals
 }// namespace DSP
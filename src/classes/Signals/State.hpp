@@ -0,0 +1,59 @@
+#ifndef STATE_HPP
+#define STATE_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <type_traits>
+
+namespace DSP
+{
+namespace Signals
+{
+    /**
+     * @class StateBuffer
+     * @brief Byte snapshot of a stateful signal, written and read back in the same order
+     */
+    class StateBuffer
+    {
+    public:
+        template<class T> requires std::is_trivially_copyable_v<T>
+        void write(const T& value)
+        {
+            const auto* data = reinterpret_cast<const std::byte*>(&value);
+            bytes.insert(bytes.end(), data, data + sizeof(T));
+        }
+        template<class T> requires std::is_trivially_copyable_v<T>
+        void write(const std::vector<T>& values)
+        {
+            write(values.size());
+            const auto* data = reinterpret_cast<const std::byte*>(values.data());
+            bytes.insert(bytes.end(), data, data + values.size() * sizeof(T));
+        }
+
+        template<class T> requires std::is_trivially_copyable_v<T>
+        void read(T& value)
+        {
+            std::memcpy(&value, bytes.data() + readPosition, sizeof(T));
+            readPosition += sizeof(T);
+        }
+        template<class T> requires std::is_trivially_copyable_v<T>
+        void read(std::vector<T>& values)
+        {
+            size_t count = 0;
+            read(count);
+            values.resize(count);
+            std::memcpy(values.data(), bytes.data() + readPosition, count * sizeof(T));
+            readPosition += count * sizeof(T);
+        }
+
+        void rewind() { readPosition = 0; }
+        size_t size() const { return bytes.size(); }
+    private:
+        std::vector<std::byte> bytes;
+        size_t readPosition = 0;
+    };
+}// namespace Signals
+}// namespace DSP
+
+#endif
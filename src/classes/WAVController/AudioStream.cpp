@@ -0,0 +1,107 @@
+#include "AudioStream.hpp"
+
+#include <Windows.h>
+#include <mmreg.h>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <print>
+
+#include "Render/Renderer.hpp"
+
+extern const uint32_t SAMPLE_RATE;
+
+bool AudioStream::start(const DSP::GraphDesc& desc, uint32_t outputNode)
+{
+    stop();
+    graph = std::make_unique<DSP::Graph>(desc);
+    if(!graph->hasNode(outputNode))
+    {
+        std::print(stderr, "Output node {} is missing from the graph\n", outputNode);
+        return false;
+    }
+    node = outputNode;
+    monitor.reset(cBlockFrames, SAMPLE_RATE);
+    stopRequested.store(false);
+    playing.store(true, std::memory_order_release);
+    thread = std::thread(&AudioStream::run, this);
+    return true;
+}
+
+void AudioStream::stop()
+{
+    stopRequested.store(true, std::memory_order_release);
+    if(thread.joinable())
+        thread.join();
+    playing.store(false, std::memory_order_release);
+}
+
+void AudioStream::run()
+{
+    DSP::Renderer renderer(graph->getSignal(node));
+    if(!renderer.isValid())
+    {
+        playing.store(false, std::memory_order_release);
+        return;
+    }
+
+    WAVEFORMATEX wfx{};
+    wfx.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+    wfx.nChannels = 1;
+    wfx.nSamplesPerSec = SAMPLE_RATE;
+    wfx.wBitsPerSample = 32;
+    wfx.nBlockAlign = wfx.nChannels * wfx.wBitsPerSample / 8;
+    wfx.nAvgBytesPerSec = wfx.nSamplesPerSec * wfx.nBlockAlign;
+
+    HANDLE event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    HWAVEOUT device;
+    if(waveOutOpen(&device, WAVE_MAPPER, &wfx, reinterpret_cast<DWORD_PTR>(event), 0, CALLBACK_EVENT) != MMSYSERR_NOERROR)
+    {
+        std::print(stderr, "Failed to open wave output device.\n");
+        CloseHandle(event);
+        playing.store(false, std::memory_order_release);
+        return;
+    }
+
+    std::array<std::vector<float>, cBuffers> blocks;
+    std::array<WAVEHDR, cBuffers> headers{};
+    auto submit = [&](size_t index) {
+        auto start = std::chrono::steady_clock::now();
+        renderer.render(blocks[index]);
+        monitor.recordBlock(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        waveOutWrite(device, &headers[index], sizeof(WAVEHDR));
+    };
+    for(size_t i = 0; i < cBuffers; ++i)
+    {
+        blocks[i].resize(cBlockFrames);
+        headers[i].lpData = reinterpret_cast<LPSTR>(blocks[i].data());
+        headers[i].dwBufferLength = cBlockFrames * sizeof(float);
+        waveOutPrepareHeader(device, &headers[i], sizeof(WAVEHDR));
+        submit(i);
+    }
+
+    // Blocks finish in the order they were queued, so refill from the oldest one
+    const DWORD timeout = static_cast<DWORD>(1000.0 * cBlockFrames * cBuffers / SAMPLE_RATE) + 1;
+    size_t next = 0;
+    while(!stopRequested.load(std::memory_order_acquire))
+    {
+        WaitForSingleObject(event, timeout);
+        size_t done = 0;
+        for(auto& header : headers)
+            done += (header.dwFlags & WHDR_DONE) ? 1 : 0;
+        if(done == cBuffers)
+            monitor.recordXrun();
+        while(headers[next].dwFlags & WHDR_DONE)
+        {
+            submit(next);
+            next = (next + 1) % cBuffers;
+        }
+    }
+
+    waveOutReset(device);
+    for(auto& header : headers)
+        waveOutUnprepareHeader(device, &header, sizeof(WAVEHDR));
+    waveOutClose(device);
+    CloseHandle(event);
+    playing.store(false, std::memory_order_release);
+}
@@ -0,0 +1,48 @@
+#ifndef AUDIOSTREAM_HPP
+#define AUDIOSTREAM_HPP
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <atomic>
+
+#include "Graph/Graph.hpp"
+#include "Render/DeadlineMonitor.hpp"
+
+/**
+ * @class AudioStream
+ * @brief Plays an Output node through the default device, rendering one block ahead of the device
+ *
+ * The stream builds its own Graph from a description, so the audio thread never touches the
+ * editor's signals. cBuffers blocks stay queued on the device; finding all of them played
+ * when the thread wakes up means the output ran dry and counts as an xrun.
+ */
+class AudioStream
+{
+public:
+    static constexpr uint32_t cBlockFrames = 512;
+    static constexpr uint32_t cBuffers = 3;
+
+    AudioStream() = default;
+    AudioStream(const AudioStream&) = delete;
+    AudioStream& operator=(const AudioStream&) = delete;
+    ~AudioStream() { stop(); }
+
+    bool start(const DSP::GraphDesc& desc, uint32_t outputNode);
+    void stop();
+
+    bool isPlaying() const { return playing.load(std::memory_order_acquire); }
+    uint32_t getNode() const { return node; }
+    const DSP::DeadlineMonitor& getMonitor() const { return monitor; }
+private:
+    void run();
+
+    std::unique_ptr<DSP::Graph> graph;
+    uint32_t node = 0;
+    std::thread thread;
+    std::atomic<bool> playing = false;
+    std::atomic<bool> stopRequested = false;
+    DSP::DeadlineMonitor monitor;
+};
+
+#endif
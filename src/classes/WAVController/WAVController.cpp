@@ -1,12 +1,13 @@
 #include "WAVController.hpp"
 
-#include <Windows.h>
-#include <mmreg.h>
 #include <cstdint>
+#include <fstream>
+#include <cstring>
+#include <iterator>
 #include <print>
+#include <algorithm>
 
 extern const uint32_t SAMPLE_RATE;
-extern const uint32_t DURATION;
 
 static constexpr uint16_t cBitsPerSample = 32;
 static constexpr uint16_t cChannels = 1;
@@ -32,80 +33,172 @@ struct WAVHeader {
     char dataChunkID[4] = { 'd', 'a', 't', 'a' };
     uint32_t dataChunkSize;  // Size of the audio data
 };
+
+// RF64 (EBU Tech 3306) keeps the real sizes in a ds64 chunk and marks the 32-bit ones as 0xFFFFFFFF
+struct RF64Header {
+    char rf64[4] = { 'R', 'F', '6', '4' };
+    uint32_t fileSize = UINT32_MAX;
+    char wave[4] = { 'W', 'A', 'V', 'E' };
+
+    char ds64ChunkID[4] = { 'd', 's', '6', '4' };
+    uint32_t ds64ChunkSize = 28;
+    uint64_t riffSize;       // Size of the entire file minus 8 bytes
+    uint64_t dataSize;
+    uint64_t sampleCount;    // Frames in the data chunk
+    uint32_t tableLength = 0;
+};
 #pragma pack(pop)
 
-void WAVController::PlaylayWAV(const std::vector<float>& data)
+void WAVController::WriteWAVHeader(std::ostream& out, uint64_t sampleCount)
 {
-    // Set up the waveform audio format
-    WAVEFORMATEX wfx;
-    wfx.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
-    wfx.nChannels = cChannels;  // Mono
-    wfx.nSamplesPerSec = SAMPLE_RATE;
-    wfx.wBitsPerSample = cBitsPerSample;  // 32-bit float audio
-    wfx.nBlockAlign = wfx.nChannels * wfx.wBitsPerSample / 8;
-    wfx.nAvgBytesPerSec = wfx.nSamplesPerSec * wfx.nBlockAlign;
-    wfx.cbSize = 0;
-
-
-    WAVEHDR whdr;
-    whdr.lpData = (LPSTR)data.data();
-    whdr.dwBufferLength = data.size() * sizeof(float);
-    whdr.dwFlags = 0;
-    whdr.dwLoops = 0;
-
-    HWAVEOUT hWaveOut;
-    if (waveOutOpen(&hWaveOut, WAVE_MAPPER, &wfx, 0, 0, CALLBACK_NULL) != MMSYSERR_NOERROR) 
+    WAVHeader header;
+    header.numChannels = cChannels;
+    header.sampleRate = SAMPLE_RATE;
+    header.bitsPerSample = cBitsPerSample;
+    header.blockAlign = header.numChannels * header.bitsPerSample / 8;
+    header.byteRate = SAMPLE_RATE * header.blockAlign;
+    const uint64_t dataBytes = sampleCount * header.blockAlign;
+    const uint64_t fileSize = sizeof(WAVHeader) - 8 + dataBytes;
+    if(fileSize <= UINT32_MAX)
     {
-        std::print(stderr, "Failed to open wave output device.\n");
+        header.dataChunkSize = static_cast<uint32_t>(dataBytes);
+        header.fileSize = static_cast<uint32_t>(fileSize);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        return;
     }
 
-    waveOutPrepareHeader(hWaveOut, &whdr, sizeof(WAVEHDR));
-    waveOutWrite(hWaveOut, &whdr, sizeof(WAVEHDR));
-
-    Sleep(DURATION * 1000);
+    // The ds64 chunk goes in front of fmt, so the RIFF form of the header follows it from fmt on
+    RF64Header rf64;
+    rf64.riffSize = sizeof(RF64Header) + sizeof(WAVHeader) - 12 - 8 + dataBytes;
+    rf64.dataSize = dataBytes;
+    rf64.sampleCount = sampleCount / header.numChannels;
+    header.dataChunkSize = UINT32_MAX;
+    out.write(reinterpret_cast<const char*>(&rf64), sizeof(rf64));
+    out.write(reinterpret_cast<const char*>(&header) + 12, sizeof(header) - 12);
+}
 
-    waveOutUnprepareHeader(hWaveOut, &whdr, sizeof(WAVEHDR));
-    waveOutClose(hWaveOut);
+void WAVController::WriteSamples(std::ostream& out, std::span<const float> data)
+{
+    out.write(reinterpret_cast<const char*>(data.data()), data.size_bytes());
 }
 
 void WAVController::CreateWAVFile(std::string &&name, const std::vector<float> &data)
 {
-    // Create and initialize the WAV header
-    WAVHeader header;
-    header.numChannels = cChannels;
-    header.sampleRate = SAMPLE_RATE;
-    header.bitsPerSample = cBitsPerSample;
-    header.blockAlign = header.numChannels * header.bitsPerSample / 8;
-    header.byteRate = SAMPLE_RATE * header.blockAlign;
-    header.dataChunkSize = data.size() * sizeof(float);
-    header.fileSize = sizeof(WAVHeader) + header.dataChunkSize;
-
-    // Create the WAV file using WinAPI
-    HANDLE hFile = CreateFileA(
-        name.c_str(),
-        GENERIC_WRITE,
-        0,
-        nullptr,
-        CREATE_ALWAYS,
-        FILE_ATTRIBUTE_NORMAL,
-        nullptr
-    );
-
-    if (hFile == INVALID_HANDLE_VALUE) {
+    std::ofstream file(name, std::ios::binary);
+    if (!file) {
         std::print(stderr, "Failed to create file: {}", name);
         return;
     }
 
-    // Write WAV header
-    DWORD bytesWritten;
-    WriteFile(hFile, &header, sizeof(header), &bytesWritten, nullptr);
-
-    // Write audio data (IEEE Float data)
-    WriteFile(hFile, data.data(), header.dataChunkSize, &bytesWritten, nullptr);
-    int err = GetLastError();
-    // Close the file
-    CloseHandle(hFile);
+    WriteWAVHeader(file, data.size());
+    WriteSamples(file, data);
+    if (!file) {
+        std::print(stderr, "Failed to write file: {}", name);
+        return;
+    }
     std::print("WAV file created: {}", name);
 }
 
+static float ReadSample(const char* data, uint16_t format, uint16_t bits)
+{
+    if(format == 3)
+    {
+        if(bits == 64)
+        {
+            double value;
+            std::memcpy(&value, data, sizeof(value));
+            return static_cast<float>(value);
+        }
+        float value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+    switch(bits)
+    {
+        case 8:
+            return (static_cast<uint8_t>(data[0]) - 128) / 128.0f;
+        case 16:
+        {
+            int16_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value / 32768.0f;
+        }
+        case 24:
+        {
+            const int32_t value = static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint8_t>(data[0])) << 8 |
+                static_cast<uint32_t>(static_cast<uint8_t>(data[1])) << 16 |
+                static_cast<uint32_t>(static_cast<uint8_t>(data[2])) << 24) >> 8;
+            return value / 8388608.0f;
+        }
+        default:
+        {
+            int32_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value / 2147483648.0f;
+        }
+    }
+}
+
+std::optional<std::vector<float>> WAVController::ReadWAVFile(const std::string& name)
+{
+    std::ifstream file(name, std::ios::binary);
+    if (!file) {
+        std::print(stderr, "Failed to open file: {}\n", name);
+        return std::nullopt;
+    }
+    const std::vector<char> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    // RF64 data sizes are 0xFFFFFFFF, which the chunk walk below already clamps to the end of the file
+    const bool riff = bytes.size() >= 12 && (std::memcmp(bytes.data(), "RIFF", 4) == 0 || std::memcmp(bytes.data(), "RF64", 4) == 0);
+    if (!riff || std::memcmp(bytes.data() + 8, "WAVE", 4) != 0) {
+        std::print(stderr, "Not a WAV file: {}\n", name);
+        return std::nullopt;
+    }
+
+    uint16_t format = 0, channels = 0, bits = 0;
+    uint32_t sampleRate = 0;
+    const char* data = nullptr;
+    size_t dataSize = 0;
+    for(size_t pos = 12; pos + 8 <= bytes.size();)
+    {
+        uint32_t chunkSize;
+        std::memcpy(&chunkSize, bytes.data() + pos + 4, sizeof(chunkSize));
+        const char* chunk = bytes.data() + pos + 8;
+        const size_t available = std::min<size_t>(chunkSize, bytes.size() - pos - 8);
+        if(std::memcmp(bytes.data() + pos, "fmt ", 4) == 0 && available >= 16)
+        {
+            std::memcpy(&format, chunk, 2);
+            std::memcpy(&channels, chunk + 2, 2);
+            std::memcpy(&sampleRate, chunk + 4, 4);
+            std::memcpy(&bits, chunk + 14, 2);
+            // WAVE_FORMAT_EXTENSIBLE keeps the real format in the sub format GUID
+            if(format == 0xFFFE && available >= 26)
+                std::memcpy(&format, chunk + 24, 2);
+        }
+        else if(std::memcmp(bytes.data() + pos, "data", 4) == 0)
+        {
+            data = chunk;
+            dataSize = available;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    const bool supported = (format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) ||
+        (format == 3 && (bits == 32 || bits == 64));
+    if (!data || channels == 0 || !supported) {
+        std::print(stderr, "Unsupported WAV format in {}\n", name);
+        return std::nullopt;
+    }
+    if (sampleRate != SAMPLE_RATE)
+        std::print(stderr, "{} is {} Hz, used as is at {} Hz\n", name, sampleRate, SAMPLE_RATE);
 
+    const size_t frameSize = channels * (bits / 8);
+    std::vector<float> samples(dataSize / frameSize);
+    for(size_t i = 0; i < samples.size(); ++i)
+    {
+        float sum = 0.0f;
+        for(uint16_t channel = 0; channel < channels; ++channel)
+            sum += ReadSample(data + i * frameSize + channel * (bits / 8), format, bits);
+        samples[i] = sum / channels;
+    }
+    return samples;
+}
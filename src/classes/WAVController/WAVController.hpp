@@ -1,17 +1,28 @@
 #ifndef WAVCONTROLLER_HPP
 #define WAVCONTROLLER_HPP
 
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <span>
+#include <ostream>
+#include <optional>
 
 class WAVController
 {
 public: 
     static void PlaylayWAV(const std::vector<float>& data);
     static void CreateWAVFile(std::string&& name, const std::vector<float>& data);
+
+    // Files past the 4 GB a RIFF header can hold get an RF64 header with 64-bit sizes instead
+    static void WriteWAVHeader(std::ostream& out, uint64_t sampleCount);
+    static void WriteSamples(std::ostream& out, std::span<const float> data);
+
+    // PCM 8/16/24/32 bit or 32/64 bit float, channels are mixed down to mono
+    static std::optional<std::vector<float>> ReadWAVFile(const std::string& name);
 private:
 
 
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,46 @@
+#include "WAVController.hpp"
+
+#include <Windows.h>
+#include <mmreg.h>
+#include <cstdint>
+#include <print>
+
+extern const uint32_t SAMPLE_RATE;
+extern const uint32_t DURATION;
+
+static constexpr uint16_t cBitsPerSample = 32;
+static constexpr uint16_t cChannels = 1;
+
+void WAVController::PlaylayWAV(const std::vector<float>& data)
+{
+    // Set up the waveform audio format
+    WAVEFORMATEX wfx;
+    wfx.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+    wfx.nChannels = cChannels;  // Mono
+    wfx.nSamplesPerSec = SAMPLE_RATE;
+    wfx.wBitsPerSample = cBitsPerSample;  // 32-bit float audio
+    wfx.nBlockAlign = wfx.nChannels * wfx.wBitsPerSample / 8;
+    wfx.nAvgBytesPerSec = wfx.nSamplesPerSec * wfx.nBlockAlign;
+    wfx.cbSize = 0;
+
+
+    WAVEHDR whdr;
+    whdr.lpData = (LPSTR)data.data();
+    whdr.dwBufferLength = data.size() * sizeof(float);
+    whdr.dwFlags = 0;
+    whdr.dwLoops = 0;
+
+    HWAVEOUT hWaveOut;
+    if (waveOutOpen(&hWaveOut, WAVE_MAPPER, &wfx, 0, 0, CALLBACK_NULL) != MMSYSERR_NOERROR) 
+    {
+        std::print(stderr, "Failed to open wave output device.\n");
+    }
+
+    waveOutPrepareHeader(hWaveOut, &whdr, sizeof(WAVEHDR));
+    waveOutWrite(hWaveOut, &whdr, sizeof(WAVEHDR));
+
+    Sleep(DURATION * 1000);
+
+    waveOutUnprepareHeader(hWaveOut, &whdr, sizeof(WAVEHDR));
+    waveOutClose(hWaveOut);
+}
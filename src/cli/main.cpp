@@ -0,0 +1,325 @@
+#include <print>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <charconv>
+#include <thread>
+#include <algorithm>
+#include <iostream>
+
+#include "Graph/Graph.hpp"
+#include "Graph/GraphIO.hpp"
+#include "Render/RenderJob.hpp"
+#include "Render/BatchRenderer.hpp"
+#include "Render/ThreadPool.hpp"
+#include "Render/Profiler.hpp"
+#include "Render/VoiceEngine.hpp"
+#include "Render/Verifier.hpp"
+#include "Math/FastMath.hpp"
+
+extern const uint32_t SAMPLE_RATE = 44100;
+extern const uint32_t DURATION = 4;
+
+struct Options
+{
+    DSP::RenderJob job;
+    std::string convertPath;
+    std::string batchPath;
+    std::string reportPath;
+    std::string cacheDir;
+    std::string verifyPath;
+    uint32_t verifyEvery = 0;
+    DSP::Verifier::Tolerances tolerances = DSP::Verifier::cDefaultTolerances;
+    size_t cacheMegabytes = DSP::RenderCache::cDefaultBytes >> 20;
+    size_t jobs = 0;
+    bool mathReport = false;
+};
+
+static void printUsage()
+{
+    std::print(stderr,
+        "Usage: dsp_render <graph> [options]\n"
+        "       dsp_render --batch <manifest> [--jobs N] [--report <csv>] [--duration <sec>]\n"
+        "  -o <path>          output file, '-' for stdout (default)\n"
+        "  --raw              write raw 32-bit float PCM instead of WAV\n"
+        "  --duration <sec>   render length in seconds, streamed in constant memory (default {})\n"
+        "  --node <id>        Output node to render (default: first one)\n"
+        "  --precision <p>    block engine sample type: double (default) or float\n"
+        "  --accuracy <a>     sin/cos/exp/tanh tier: exact (default), high (~1e-7) or fast (~1e-4)\n"
+        "  --no-period-cache  compute periodic subgraphs sample by sample instead of looping one period\n"
+        "  --memory-budget <mb>\n"
+        "                     block buffer memory per graph, reported when exceeded (default: unlimited)\n"
+        "  --math-report      print the measured error and speed of every accuracy tier as CSV and exit\n"
+        "  --profile <path>   write per-node timings as CSV, or JSON for *.json (needs a DSP_PROFILE build)\n"
+        "  --deadline-log <path>\n"
+        "                     time every 256 frames against real time, write the load histogram as JSON\n"
+        "  --convert <path>   save the graph as JSON (*.json) or binary and exit\n"
+        "  --verify <path>    compare every node's block engine output with its per-sample get() over the\n"
+        "                     duration, on its own and as read inside every Output's render,\n"
+        "                     write the errors as CSV ('-' for stdout) or JSON and exit, 1 on divergence\n"
+        "  --verify-every <n> compare one {}-sample block out of every n instead of every sample\n"
+        "  --tolerance <spec> divergence threshold per accuracy tier: exact=<t>,high=<t>,fast=<t>\n"
+        "                     (default exact=1e-9,high=1e-6,fast=1e-3, at least 1e-5 with float precision)\n"
+        "  --notes <n1>,...   play MIDI notes through the graph as a polyphonic voice, held for the whole render\n"
+        "  --voices <n>       voices of --notes and --midi, 1 to 16 (default 8)\n"
+        "  --midi <path>      play a Standard MIDI File through the graph as a polyphonic voice,\n"
+        "                     the render lasts until the last event plus one second\n"
+        "  --cc <spec>        map a MIDI controller onto a Constant: <cc>=<node> or <cc>=<node>:<min>:<max>\n"
+        "  --sweep <spec>     render variants of a Constant: <node>=<v1>,<v2>,... or <node>=<from>:<to>:<count>\n"
+        "                     one output per variant, '{{}}' in -o is replaced by the variant index\n"
+        "  --batch <path>     render every '<graph> <output> [duration] [node]' line of a manifest\n"
+        "  --jobs <n>         concurrent batch jobs (default: hardware threads)\n"
+        "  --report <path>    write per-job timings as CSV\n"
+        "  --cache-dir <path> keep renders on disk by graph content and reuse them, also across runs\n"
+        "  --cache-size <mb>  memory for renders reused within a batch (default {}), 0 turns it off\n",
+        DURATION, DSP::Signals::Block::cMaxSize, DSP::RenderCache::cDefaultBytes >> 20
+    );
+}
+
+template<class T>
+static bool parseNumber(std::string_view str, T& value)
+{
+    auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc() && end == str.data() + str.size();
+}
+
+static bool parseArgs(int argc, char** argv, Options& options)
+{
+    auto& job = options.job;
+    job.duration = DURATION;
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(arg == "-o" && hasValue)
+            job.outputPath = argv[++i];
+        else if(arg == "--convert" && hasValue)
+            options.convertPath = argv[++i];
+        else if(arg == "--batch" && hasValue)
+            options.batchPath = argv[++i];
+        else if(arg == "--report" && hasValue)
+            options.reportPath = argv[++i];
+        else if(arg == "--profile" && hasValue)
+            job.profilePath = argv[++i];
+        else if(arg == "--verify" && hasValue)
+            options.verifyPath = argv[++i];
+        else if(arg == "--verify-every" && hasValue)
+        {
+            if(!parseNumber(argv[++i], options.verifyEvery))
+                return false;
+        }
+        else if(arg == "--tolerance" && hasValue)
+        {
+            auto tolerances = DSP::Verifier::ParseTolerances(argv[++i], options.tolerances);
+            if(!tolerances)
+                return false;
+            options.tolerances = *tolerances;
+        }
+        else if(arg == "--deadline-log" && hasValue)
+            job.deadlineLog = argv[++i];
+        else if(arg == "--sweep" && hasValue)
+        {
+            auto parameter = DSP::Sweep::Parse(argv[++i]);
+            if(!parameter)
+                return false;
+            job.sweep.push_back(std::move(*parameter));
+        }
+        else if(arg == "--notes" && hasValue)
+        {
+            std::string_view list = argv[++i];
+            while(!list.empty())
+            {
+                size_t comma = list.find(',');
+                uint8_t note;
+                if(!parseNumber(list.substr(0, comma), note) || note > 127)
+                    return false;
+                job.notes.push_back(note);
+                list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+            }
+        }
+        else if(arg == "--midi" && hasValue)
+            job.midiPath = argv[++i];
+        else if(arg == "--cc" && hasValue)
+        {
+            auto controller = DSP::Sequencer::ParseController(argv[++i]);
+            if(!controller)
+                return false;
+            job.controllers.push_back(*controller);
+        }
+        else if(arg == "--voices" && hasValue)
+        {
+            if(!parseNumber(argv[++i], job.voices) || job.voices == 0 || job.voices > DSP::VoiceEngine::cMaxVoices)
+                return false;
+        }
+        else if(arg == "--raw")
+            job.raw = true;
+        else if(arg == "--no-period-cache")
+            job.periodCache = false;
+        else if(arg == "--duration" && hasValue)
+        {
+            if(!parseNumber(argv[++i], job.duration) || job.duration <= 0.0)
+                return false;
+        }
+        else if(arg == "--precision" && hasValue)
+        {
+            std::string_view precision = argv[++i];
+            if(precision == "float")
+                job.precision = DSP::Precision::Float;
+            else if(precision == "double")
+                job.precision = DSP::Precision::Double;
+            else
+                return false;
+        }
+        else if(arg == "--accuracy" && hasValue)
+        {
+            std::string_view accuracy = argv[++i];
+            if(accuracy == "exact")
+                job.accuracy = DSP::Accuracy::Exact;
+            else if(accuracy == "high")
+                job.accuracy = DSP::Accuracy::High;
+            else if(accuracy == "fast")
+                job.accuracy = DSP::Accuracy::Fast;
+            else
+                return false;
+        }
+        else if(arg == "--math-report")
+            options.mathReport = true;
+        else if(arg == "--node" && hasValue)
+        {
+            if(!parseNumber(argv[++i], job.node))
+                return false;
+        }
+        else if(arg == "--cache-dir" && hasValue)
+            options.cacheDir = argv[++i];
+        else if(arg == "--memory-budget" && hasValue)
+        {
+            size_t megabytes = 0;
+            if(!parseNumber(argv[++i], megabytes))
+                return false;
+            job.memoryBudget = megabytes << 20;
+        }
+        else if(arg == "--cache-size" && hasValue)
+        {
+            if(!parseNumber(argv[++i], options.cacheMegabytes))
+                return false;
+        }
+        else if(arg == "--jobs" && hasValue)
+        {
+            if(!parseNumber(argv[++i], options.jobs))
+                return false;
+        }
+        else if(!arg.starts_with("-") && job.graphPath.empty())
+            job.graphPath = arg;
+        else
+            return false;
+    }
+    return options.mathReport || job.graphPath.empty() != options.batchPath.empty();
+}
+
+static int runBatch(const Options& options, DSP::RenderCache& cache)
+{
+    auto jobs = DSP::BatchRenderer::LoadManifest(options.batchPath, options.job.duration);
+    if(!jobs)
+        return 1;
+    for(auto& job : *jobs)
+    {
+        job.precision = options.job.precision;
+        job.accuracy = options.job.accuracy;
+        job.periodCache = options.job.periodCache;
+        job.memoryBudget = options.job.memoryBudget;
+        job.cache = &cache;
+    }
+
+    size_t concurrency = options.jobs ? options.jobs : std::thread::hardware_concurrency();
+    DSP::ThreadPool pool(concurrency);
+    DSP::BatchRenderer batch(pool, concurrency);
+    auto results = batch.run(*jobs);
+
+    if(!options.reportPath.empty())
+    {
+        std::ofstream report(options.reportPath);
+        DSP::BatchRenderer::WriteReport(report, *jobs, results);
+    }
+
+    size_t failed = std::count_if(results.begin(), results.end(), [](const DSP::RenderResult& result) { return !result.ok; });
+    std::print(stderr, "{} of {} jobs rendered\n", results.size() - failed, results.size());
+    return failed ? 1 : 0;
+}
+
+static int runVerify(const Options& options)
+{
+    auto desc = DSP::GraphIO::Load(options.job.graphPath);
+    if(!desc)
+        return 1;
+    DSP::Verifier::Settings settings;
+    settings.frames = static_cast<uint64_t>(options.job.duration * SAMPLE_RATE);
+    settings.precision = options.job.precision;
+    settings.accuracy = options.job.accuracy;
+    settings.periodCache = options.job.periodCache;
+    settings.every = options.verifyEvery;
+    settings.tolerances = options.tolerances;
+    auto entries = DSP::Verifier::Run(*desc, settings);
+
+    if(options.verifyPath == "-")
+        DSP::Verifier::WriteCSV(std::cout, entries);
+    else if(!DSP::Verifier::Save(options.verifyPath, entries))
+        return 1;
+    size_t failed = 0;
+    for(auto& entry : entries)
+    {
+        if(entry.passed())
+            continue;
+        std::print(stderr, "node {} ({}){} diverges at sample {}, max error {} at {}\n",
+            entry.id, entry.type, entry.root ? std::format(" in the render of Output node {}", entry.root) : "",
+            entry.firstDivergent, entry.maxError, entry.maxErrorAt);
+        ++failed;
+    }
+    std::print(stderr, "{} of {} checks within {}\n", entries.size() - failed, entries.size(), settings.tolerance());
+    return failed ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if(!parseArgs(argc, argv, options))
+    {
+        printUsage();
+        return 2;
+    }
+
+    if(options.mathReport)
+    {
+        DSP::FastMath::WriteReport(std::cout);
+        return 0;
+    }
+
+    DSP::RenderCache cache(options.cacheMegabytes << 20, options.cacheDir);
+    if(!options.batchPath.empty())
+        return runBatch(options, cache);
+
+    if(!options.convertPath.empty())
+    {
+        auto desc = DSP::GraphIO::Load(options.job.graphPath);
+        return desc && DSP::GraphIO::Save(options.convertPath, *desc) ? 0 : 1;
+    }
+
+    if(!options.verifyPath.empty())
+        return runVerify(options);
+
+    if(!options.job.profilePath.empty() && !DSP::Profiler::cEnabled)
+        std::print(stderr, "Built without DSP_PROFILE, the profile will only hold zeros\n");
+    if(options.job.outputPath == "-")
+        std::ios::sync_with_stdio(false);
+    // One render reuses nothing from memory, only the disk cache pays off
+    if(!options.cacheDir.empty())
+        options.job.cache = &cache;
+    auto result = options.job.run();
+    if(!result.ok)
+    {
+        std::print(stderr, "{}\n", result.error);
+        return 1;
+    }
+    return 0;
+}
@@ -5,6 +5,9 @@
 #include <random>
 #include <numbers>
 #include <memory>
+#include <array>
+#include <cstdio>
+#include <unordered_map>
 
 #include "imgui.h"
 #include "imnodes.h"
@@ -17,6 +20,11 @@
 #include "Signals/Signals.hpp"
 #include "WAVController/WAVController.hpp"
 #include "Bluprints/Nodes.hpp"
+#include "Graph/GraphIO.hpp"
+#include "Render/Profiler.hpp"
+#include "Render/RenderCache.hpp"
+#include "Render/RenderQueue.hpp"
+#include "WAVController/AudioStream.hpp"
 
 static void glfw_error_callback(int error, const char* description)
 {
@@ -40,6 +48,138 @@ struct Editor
     std::list<Link> links;
 };
 
+static std::unique_ptr<DSP::NodeBase> createNode(DSP::NodeType type)
+{
+    switch(type)
+    {
+        case DSP::Signal:
+            return std::make_unique<DSP::SignalNode>();
+        case DSP::Function:
+            return std::make_unique<DSP::FunctionNode>();
+        case DSP::Constant:
+            return std::make_unique<DSP::ConstantNode>();
+        case DSP::Output:
+            return std::make_unique<DSP::OutputNode>();
+        case DSP::Spectrum:
+            return std::make_unique<DSP::SpectrumNode>();
+        case DSP::Convolution:
+            return std::make_unique<DSP::ConvolutionNode>();
+        case DSP::Filter:
+            return std::make_unique<DSP::FilterNode>();
+        case DSP::Oversample:
+            return std::make_unique<DSP::OversampleNode>();
+        case DSP::OversampleInput:
+            return std::make_unique<DSP::OversampleInputNode>();
+        case DSP::Automation:
+            return std::make_unique<DSP::AutomationNode>();
+        case DSP::Formula:
+            return std::make_unique<DSP::FormulaNode>();
+    }
+    return nullptr;
+}
+
+static DSP::NodeBase* findNode(Editor& editor, uint32_t id)
+{
+    auto iter = std::find_if(editor.nodes.begin(), editor.nodes.end(), [id](std::unique_ptr<DSP::NodeBase>& node) -> bool {
+        return node->getId() == id;
+    });
+    return iter != editor.nodes.end() ? iter->get() : nullptr;
+}
+
+static bool connectLink(Editor& editor, const Link& link)
+{
+    if(((link.start_attr & DSP::NodeBase::AttribIdMask) >= 0x0002'0000) || // check if it is an output attribute
+        (link.end_attr & DSP::NodeBase::AttribIdMask) < 0x0002'0000) // check if it is an input attribute
+        return false;
+
+    DSP::NodeBase* startNode = findNode(editor, link.start_attr & DSP::NodeBase::NodeIdMask);
+    DSP::NodeBase* endNode = findNode(editor, link.end_attr & DSP::NodeBase::NodeIdMask);
+    if(!startNode || !endNode)
+        return false;
+
+    auto& OutputSignal = startNode->getSignal();
+    if(DSP::Graph::isSink(endNode->getType()))
+    {
+        endNode->setSignal(OutputSignal);
+        return true;
+    }
+    return DSP::Graph::connect(
+        endNode->getType(),
+        (link.end_attr & DSP::NodeBase::AttribIdMask) >> 16,
+        endNode->getSignal(),
+        OutputSignal
+    );
+}
+
+static DSP::GraphDesc describeEditor(const Editor& editor)
+{
+    DSP::GraphDesc desc;
+    for(auto& node : editor.nodes)
+    {
+        auto nodeDesc = node->getDesc();
+        nodeDesc.text = desc.addText(node->getText());
+        desc.nodes.push_back(nodeDesc);
+    }
+    for(auto& link : editor.links)
+    {
+        desc.links.push_back({
+            static_cast<uint32_t>(link.start_attr & DSP::NodeBase::NodeIdMask),
+            static_cast<uint32_t>(link.end_attr & DSP::NodeBase::NodeIdMask),
+            static_cast<uint32_t>(link.end_attr & DSP::NodeBase::AttribIdMask) >> 16
+        });
+    }
+    return desc;
+}
+
+static void loadEditor(Editor& editor, const DSP::GraphDesc& desc)
+{
+    editor.links.clear();
+    editor.nodes.clear();
+
+    std::unordered_map<uint32_t, uint32_t> ids;
+    for(auto& nodeDesc : desc.nodes)
+    {
+        auto node = createNode(nodeDesc.type);
+        if(!node)
+            continue;
+        node->setDesc(nodeDesc);
+        node->setText(desc.getText(nodeDesc));
+        ImNodes::SetNodeGridSpacePos(node->getId(), ImVec2(nodeDesc.x, nodeDesc.y));
+        ids[nodeDesc.id] = node->getId();
+        editor.nodes.push_back(std::move(node));
+    }
+    for(auto& linkDesc : desc.links)
+    {
+        if(!ids.contains(linkDesc.from) || !ids.contains(linkDesc.to))
+            continue;
+        Link link;
+        link.id = ++id_counter;
+        link.start_attr = ids[linkDesc.from] + (DSP::OutPort << 16);
+        link.end_attr = ids[linkDesc.to] + (linkDesc.port << 16);
+        if(connectLink(editor, link))
+            editor.links.push_back(link);
+    }
+}
+
+// Sinks share their input's signal, so only nodes with an output of their own are listed
+static std::vector<DSP::ProfileEntry> collectProfile(const Editor& editor)
+{
+    std::vector<DSP::ProfileEntry> entries;
+    for(auto& node : editor.nodes)
+    {
+        auto& signal = node->getSignal();
+        if(DSP::Graph::isSink(node->getType()) || !signal || !*signal)
+            continue;
+        DSP::ProfileEntry entry;
+        entry.id = node->getId();
+        entry.type = node->getName();
+        if(auto* counters = (*signal)->getProfile())
+            entry.counters = *counters;
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
 // Main code
 int main(int, char**)
 {
@@ -88,6 +228,9 @@ int main(int, char**)
     double offset = 0.0;
     bool isAnimated = true;
     Editor editor;
+    AudioStream audio;
+    DSP::RenderCache renderCache;
+    DSP::RenderQueue renderQueue;
     
     while (!glfwWindowShouldClose(window))
     {
@@ -120,7 +263,7 @@ int main(int, char**)
             {
                 const ImVec2 click_pos = ImGui::GetMousePosOnOpeningCurrentPopup();
 
-                static const char* names[] = {"Signals", "Functions", "Constants", "Outputs"};
+                static const char* names[] = {"Signals", "Functions", "Constants", "Outputs", "Spectrums", "Convolutions", "Filters", "Oversamples", "Oversample inputs", "Automations", "Formulas"};
                 ImGui::SeparatorText("Aquarium");
                 for (int i = 0; i < IM_ARRAYSIZE(names); i++)
                     if (ImGui::Selectable(names[i]))
@@ -129,31 +272,34 @@ int main(int, char**)
                 if(selected_node_type != -1)
                 {
                     const int node_id = ++id_counter;
-                    switch(selected_node_type)
-                    {
-                        case 0:
-                            editor.nodes.push_back(std::make_unique<DSP::SignalNode>());
-                            break;
-                        case 1:
-                            editor.nodes.push_back(std::make_unique<DSP::FunctionNode>());
-                            break;
-                        case 2:
-                            editor.nodes.push_back(std::make_unique<DSP::ConstantNode>());
-                            break;
-                        case 3:
-                            editor.nodes.push_back(std::make_unique<DSP::OutputNode>());
-                            break;
-                    }
+                    editor.nodes.push_back(createNode(static_cast<DSP::NodeType>(selected_node_type)));
                     selected_node_type = -1;
                     ImNodes::SetNodeScreenSpacePos(editor.nodes.back()->getId(), click_pos);
                 }
             }
 
 
+            if constexpr(DSP::Profiler::cEnabled)
+                DSP::NodeBase::SetProfileTotal(DSP::Profiler::TotalNanoseconds(collectProfile(editor)));
             for(auto& node : editor.nodes)
             {
                 node->Draw();
             }
+            for(auto& node : editor.nodes)
+            {
+                auto* output = dynamic_cast<DSP::OutputNode*>(node.get());
+                if(output && output->takePlayRequest())
+                    audio.start(describeEditor(editor), output->getId());
+                if(output && output->takeSaveRequest())
+                {
+                    DSP::RenderJob job;
+                    job.outputPath = output->getSavePath();
+                    job.duration = output->getSaveSeconds();
+                    job.node = output->getId();
+                    job.cache = &renderCache;
+                    output->setSaveTask(renderQueue.submit(std::move(job), describeEditor(editor)));
+                }
+            }
             for(auto& link : editor.links)
             {
                 ImNodes::Link(link.id, link.start_attr, link.end_attr);
@@ -167,65 +313,8 @@ int main(int, char**)
                 if (ImNodes::IsLinkCreated(&link.start_attr, &link.end_attr))
                 {
                     link.id = ++id_counter;
-                    if(((link.start_attr & DSP::NodeBase::AttribIdMask) < 0x0002'0000) && // check if it is an output attribute
-                        (link.end_attr & DSP::NodeBase::AttribIdMask) >= 0x0002'0000) // check if it is an input attribute
-                    {
-                        uint32_t startId = link.start_attr & DSP::NodeBase::NodeIdMask;
-                        uint32_t endId = link.end_attr & DSP::NodeBase::NodeIdMask;
-
-                        auto& OutputSignal = (*std::find_if(editor.nodes.begin(), editor.nodes.end(), [startId](std::unique_ptr<DSP::NodeBase>& node) -> bool {
-                            return node->getId() == startId;
-                        }))->getSignal();
-                        std::unique_ptr<DSP::NodeBase>& endNode = *std::find_if(editor.nodes.begin(), editor.nodes.end(), [endId](std::unique_ptr<DSP::NodeBase>& node) -> bool {
-                            return node->getId() == endId;
-                        });
-
-                        switch(endNode->getType())
-                        {
-                            case DSP::Signal:
-                                switch (link.end_attr & DSP::NodeBase::AttribIdMask)
-                                {
-                                case DSP::SignalNode::InAmplitudeAttrib:
-                                    (*endNode->getSignal())->getData().amplitude = OutputSignal;
-                                    break;
-                                case DSP::SignalNode::InFrequencyAttrib:
-                                    (*endNode->getSignal())->getData().freq = OutputSignal;
-                                    break;
-                                case DSP::SignalNode::InPhaseAttrib:
-                                    (*endNode->getSignal())->getData().phase = OutputSignal;
-                                    break;
-                                case DSP::SignalNode::InDAttrib:
-                                    (*endNode->getSignal())->getData().d = OutputSignal;
-                                    break;
-                                default:
-                                    assert(false);
-                                    break;
-                                }
-                                break;
-                            case DSP::Function:
-                                switch (link.end_attr & DSP::NodeBase::AttribIdMask)
-                                {
-                                case DSP::FunctionNode::InLeftSignalAttrib:
-                                    dynamic_cast<DSP::Signals::ComplexSignal&>(*(*endNode->getSignal())).SetLeft(OutputSignal);
-                                    break;
-                                case DSP::FunctionNode::InRightSignalAttrib:
-                                    dynamic_cast<DSP::Signals::ComplexSignal&>(*(*endNode->getSignal())).SetRight(OutputSignal);
-                                    break;
-                                default:
-                                    assert(false);
-                                    break;
-                                }
-                                break;
-                            case DSP::Constant:
-                                assert(false);
-                                break;
-                            case DSP::Output:
-                                endNode->setSignal(OutputSignal);
-                        }
-
-
+                    if(connectLink(editor, link))
                         editor.links.push_back(link);
-                    }
                 }
             }
             //Link destruction internal
@@ -283,7 +372,95 @@ int main(int, char**)
 
         }ImGui::End();
 
-        
+        ImGui::SetNextWindowDockID(1u);
+        if(ImGui::Begin("Patch", static_cast<bool*>(0), ImGuiWindowFlags_NoCollapse))
+        {
+            static char patchPath[256] = "patch.dspg";
+            ImGui::SetNextItemWidth(200);
+            ImGui::InputText("Path", patchPath, sizeof(patchPath));
+            if(ImGui::Button("Save"))
+            {
+                DSP::GraphIO::Save(patchPath, describeEditor(editor));
+            }
+            ImGui::SameLine();
+            if(ImGui::Button("Load"))
+            {
+                if(auto desc = DSP::GraphIO::Load(patchPath))
+                    loadEditor(editor, *desc);
+            }
+            if constexpr(DSP::Profiler::cEnabled)
+            {
+                static char profilePath[256] = "profile.csv";
+                ImGui::SetNextItemWidth(200);
+                ImGui::InputText("Profile", profilePath, sizeof(profilePath));
+                if(ImGui::Button("Export"))
+                    DSP::Profiler::Save(profilePath, collectProfile(editor));
+                ImGui::SameLine();
+                if(ImGui::Button("Reset"))
+                {
+                    for(auto& node : editor.nodes)
+                    {
+                        auto& signal = node->getSignal();
+                        if(signal && *signal && (*signal)->getProfile())
+                            (*signal)->getProfile()->reset();
+                    }
+                }
+            }
+        }ImGui::End();
+
+        ImGui::SetNextWindowDockID(1u);
+        if(ImGui::Begin("Audio", static_cast<bool*>(0), ImGuiWindowFlags_NoCollapse))
+        {
+            const auto stats = audio.getMonitor().snapshot();
+            if(audio.isPlaying())
+                ImGui::Text("Playing Output %u", audio.getNode());
+            else
+                ImGui::TextDisabled("Stopped");
+            ImGui::SameLine();
+            if(ImGui::Button("Stop"))
+                audio.stop();
+
+            char overlay[32];
+            std::snprintf(overlay, sizeof(overlay), "CPU %.0f%%", 100.0 * stats.load);
+            ImGui::ProgressBar(static_cast<float>(std::min(stats.load, 1.0)), ImVec2(300, 0), overlay);
+            ImGui::Text("mean %.1f%%  peak %.1f%%  of %.2f ms", 100.0 * stats.meanLoad, 100.0 * stats.peakLoad, 1e3 * stats.deadlineSeconds());
+            ImGui::Text("blocks %llu  overruns %llu  xruns %llu", static_cast<unsigned long long>(stats.blocks),
+                static_cast<unsigned long long>(stats.overruns), static_cast<unsigned long long>(stats.xruns));
+            if(ImPlot::BeginPlot("Load", ImVec2(300, 150), ImPlotFlags_NoLegend))
+            {
+                std::array<double, DSP::DeadlineMonitor::cBins> loads, counts;
+                for(size_t i = 0; i < loads.size(); ++i)
+                {
+                    loads[i] = (i + 0.5) * DSP::DeadlineMonitor::cBinWidth;
+                    counts[i] = static_cast<double>(stats.histogram[i]);
+                }
+                ImPlot::SetupAxes("load", "blocks", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+                ImPlot::PlotBars("load", loads.data(), counts.data(), static_cast<int>(loads.size()), 0.9 * DSP::DeadlineMonitor::cBinWidth);
+                ImPlot::EndPlot();
+            }
+
+            static char logPath[256] = "deadline.json";
+            ImGui::SetNextItemWidth(200);
+            ImGui::InputText("Log", logPath, sizeof(logPath));
+            if(ImGui::Button("Write"))
+                DSP::DeadlineMonitor::Save(logPath, stats);
+
+            const auto cacheStats = renderCache.getStats();
+            ImGui::Text("render cache %zu entries, %.1f MB  hits %llu  misses %llu", cacheStats.entries, cacheStats.bytes / double(1 << 20),
+                static_cast<unsigned long long>(cacheStats.hits), static_cast<unsigned long long>(cacheStats.misses));
+            ImGui::SameLine();
+            if(ImGui::Button("Clear"))
+                renderCache.clear();
+
+            // Editor signals share the default pool, renders use one pool per graph
+            const auto poolStats = DSP::Signals::BufferPool::Default()->getStats();
+            ImGui::Text("block buffers %.1f KB in use, %.1f KB pooled, peak %.1f KB  reuses %llu  allocations %llu",
+                poolStats.inUse / 1024.0, poolStats.pooled / 1024.0, poolStats.peak / 1024.0,
+                static_cast<unsigned long long>(poolStats.reuses), static_cast<unsigned long long>(poolStats.allocations));
+            ImGui::SameLine();
+            if(ImGui::Button("Trim"))
+                DSP::Signals::BufferPool::Default()->trim();
+        }ImGui::End();
 
         /*ImGui::SetNextWindowDockID(1u);
         if(ImGui::Begin("Main", (bool*)0, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoMove))